@@ -1 +1,12 @@
-g++ -std=c++17 -o ./build/goose_game ./src/mt.cpp ./src/core.cpp ./src/view.cpp ./src/main.cpp
+mkdir -p ./build
+g++ -std=c++17 -O2 -pthread -o ./build/goose_game ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/view.cpp ./src/main.cpp
+g++ -std=c++17 -O2 -pthread -o ./build/goose_sim ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/sim.cpp ./src/simulate.cpp
+g++ -std=c++17 -O2 -pthread -DGOOSE_METRICS -o ./build/goose_server ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/metrics.cpp ./src/view.cpp ./src/server.cpp ./src/serve.cpp
+g++ -std=c++17 -O2 -o ./build/goose_load ./src/load.cpp
+g++ -std=c++17 -O2 -pthread -o ./build/goose_bench ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/view.cpp ./src/bench.cpp
+g++ -std=c++17 -O3 -pthread -o ./build/goose_solve ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/layout.cpp ./src/markov.cpp ./src/solve.cpp
+g++ -std=c++17 -O2 -pthread -o ./build/goose_board ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/layout.cpp ./src/board.cpp
+g++ -std=c++17 -O2 -pthread -o ./build/goose_replay ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/replay.cpp
+g++ -std=c++17 -O2 -pthread -o ./build/goose_snapshot ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/snapshot.cpp ./src/snap.cpp
+g++ -std=c++17 -O2 -pthread -o ./build/goose_tournament ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/tournament.cpp ./src/knockout.cpp
+g++ -std=c++17 -O2 -pthread -o ./build/goose_bots ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/markov.cpp ./src/bot.cpp ./src/lobby.cpp
@@ -0,0 +1,4 @@
+set -e
+mkdir -p ./build
+g++ -std=c++17 -O2 -pthread -Isrc -o ./build/registry_test ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./tests/registry_test.cpp && ./build/registry_test
+g++ -std=c++17 -O2 -pthread -Isrc -o ./build/prank_test ./src/mt.cpp ./src/core.cpp ./src/journal.cpp ./src/sim.cpp ./tests/prank_test.cpp && ./build/prank_test
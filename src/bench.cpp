@@ -0,0 +1,173 @@
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "core.hpp"
+#include "mt.hpp"
+#include "rng.hpp"
+#include "static_board.hpp"
+#include "view.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+using namespace goose_game::view;
+
+std::atomic<std::uint64_t> bench::allocations {0};
+
+void* operator new(std::size_t size) {
+  bench::allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+  // a roster of count players named player0, player1...
+  void addPlayers(App& app, unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i) {
+      app.addPlayer("player" + to_string(i));
+    }
+  }
+
+  // scatters the players on the board with a few rounds of moves
+  void scatter(Game& game, mt::Xoshiro256& random) {
+    for (unsigned int round = 0; (round < 3) && !game.hasWinner(); ++round) {
+      for (PlayerSlot slot = 0; (slot < game.getPlayers().size()) && !game.hasWinner(); ++slot) {
+        game.move(slot, random() % 6 + 1, random() % 6 + 1);
+      }
+    }
+  }
+
+  void benchGames(bench::Harness& harness, unsigned int playerCount) {
+    App app;
+    addPlayers(app, playerCount);
+    auto game = app.acquireGame();
+    mt::Xoshiro256 random(playerCount);
+    std::string text;
+    text.reserve(1024);
+    mt::StringSink sink(text);
+    std::vector<std::string> names;
+    for (auto& player : app.getPlayers().getAll()) {
+      names.push_back(player.getName());
+    }
+    const std::string suffix = " [players=" + to_string(playerCount) + "]";
+    PlayerSlot next = 0;
+
+    harness.run("Game::movePlayer(name, sink)" + suffix, [&]() {
+      if (game->hasWinner()) {
+        game->reset();
+      }
+      text.clear();
+      game->movePlayer(names[next], random() % 6 + 1, random() % 6 + 1, sink);
+      next = (next + 1) % playerCount;
+    });
+
+    harness.run("Game::movePlayer(slot, sink)" + suffix, [&]() {
+      if (game->hasWinner()) {
+        game->reset();
+      }
+      text.clear();
+      game->movePlayer(next, random() % 6 + 1, random() % 6 + 1, sink);
+      next = (next + 1) % playerCount;
+    });
+
+    harness.run("Game::move(slot) -> MoveResult" + suffix, [&]() {
+      if (game->hasWinner()) {
+        game->reset();
+      }
+      bench::keep(game->move(next, random() % 6 + 1, random() % 6 + 1));
+      next = (next + 1) % playerCount;
+    });
+
+    harness.run("Game::movePlayer(name) -> string" + suffix, [&]() {
+      if (game->hasWinner()) {
+        game->reset();
+      }
+      bench::keep(game->movePlayer(names[next], random() % 6 + 1, random() % 6 + 1));
+      next = (next + 1) % playerCount;
+    });
+
+    harness.run("Game::moveThrowingDice(name) -> string" + suffix, [&]() {
+      if (game->hasWinner()) {
+        game->reset();
+      }
+      bench::keep(game->moveThrowingDice(names[next]));
+      next = (next + 1) % playerCount;
+    });
+
+    game->reset();
+    scatter(*game, random);
+    const GamePlayers& players = game->getPlayers();
+    const Board::size_type spaces = game->getBoard().getLastIndex() + 1;
+    harness.run("GamePlayers::findPlayerOnSpace" + suffix, [&]() {
+      bench::keep(players.findPlayerOnSpace(random() % spaces, next));
+      next = (next + 1) % playerCount;
+    });
+  }
+}
+
+/*
+ * usage: goose_bench [seconds per benchmark]
+ */
+int main(int argc, char* argv[]) {
+  bench::Harness harness((argc > 1) ? strtod(argv[1], nullptr) : 0.2);
+
+  for (unsigned int playerCount : {2, 16, 256}) {
+    benchGames(harness, playerCount);
+  }
+
+  const std::string fullArgs = " Pippo 3, 4";
+  const std::string nameOnly = " Pippo";
+  const std::string badDice = " Pippo 3, x";
+  harness.run("MoveArgs::parse(name, dice)", [&]() {
+    bench::keep(MoveArgs::parse(fullArgs));
+  });
+  harness.run("MoveArgs::parse(name)", [&]() {
+    bench::keep(MoveArgs::parse(nameOnly));
+  });
+  harness.run("MoveArgs::parse(bad dice)", [&]() {
+    bench::keep(MoveArgs::parse(badDice));
+  });
+
+  const std::string name = "Pippo";
+  Board::size_type position = 0;
+  harness.run("mt::string_format", [&]() {
+    bench::keep(mt::string_format(Messages::PLAYER_MOVES_FROM_TO, name.c_str(), "Start", ++position));
+  });
+
+  std::string text;
+  text.reserve(256);
+  mt::StringSink sink(text);
+  harness.run("mt::format_to", [&]() {
+    text.clear();
+    mt::format_to(sink, Messages::PLAYER_MOVES_FROM_TO, name.c_str(), "Start", ++position);
+  });
+
+  Dice dice(1);
+  harness.run("Dice::roll", [&]() {
+    bench::keep(dice.roll());
+  });
+
+  position = 0;
+  const Board& board = *Board::classic();
+  harness.run("Board::getMove", [&]() {
+    position = board.getMove(position, 2 + (position & 7)).target % board.getLastIndex();
+    bench::keep(position);
+  });
+  position = 0;
+  harness.run("ClassicBoard::getMove", [&]() {
+    position = CLASSIC_BOARD.getMove(position, 2 + (position & 7)).target % CLASSIC_BOARD.getLastIndex();
+    bench::keep(position);
+  });
+}
@@ -0,0 +1,57 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace bench {
+
+  // allocations made so far; the benchmark binary counts them in operator new
+  extern std::atomic<std::uint64_t> allocations;
+
+  // keeps the compiler from optimizing a result away
+  template<class T>
+  inline void keep(T const& value) {
+      asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /**
+    * Runs an operation in batches until a minimum time has elapsed,
+    * then prints ns/op, allocations/op and throughput.
+    */
+  class Harness {
+  public:
+    inline explicit Harness(double minSeconds = 0.2) : minSeconds(minSeconds) {
+        std::printf("%-52s %12s %12s %14s\n", "benchmark", "ns/op", "allocs/op", "ops/s");
+    };
+
+    template<class Op>
+    void run(const std::string& name, Op&& op) {
+        typedef std::chrono::steady_clock clock;
+        std::uint64_t iterations = 0, batch = 1;
+        std::uint64_t allocationsBefore = allocations.load(std::memory_order_relaxed);
+        auto start = clock::now();
+        std::chrono::duration<double> elapsed {0};
+
+        while (elapsed.count() < minSeconds) {
+            for (std::uint64_t i = 0; i < batch; ++i) {
+                op();
+            }
+            iterations += batch;
+            batch *= 2;
+            elapsed = clock::now() - start;
+        }
+
+        double allocs = double(allocations.load(std::memory_order_relaxed) - allocationsBefore) / iterations;
+        double ns = elapsed.count() * 1e9 / iterations;
+        std::printf("%-52s %12.1f %12.2f %14.0f\n", name.c_str(), ns, allocs, iterations / elapsed.count());
+    };
+  private:
+    double minSeconds;
+  };
+}
+
+#endif //BENCH_H
@@ -0,0 +1,46 @@
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "core.hpp"
+#include "layout.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+/*
+ * usage: goose_board compile <layout> <binary>
+ *        goose_board show <layout-or-binary>
+ *        goose_board catalog <directory>
+ */
+int main(int argc, char* argv[]) {
+  const string command = (argc > 1) ? argv[1] : "";
+  try {
+    if ( (command == "compile") && (argc == 4) ) {
+      BoardFile::saveBinary(*BoardFile::loadText(argv[2]), argv[3]);
+    } else if ( (command == "show") && (argc == 3) ) {
+      auto start = chrono::steady_clock::now();
+      auto board = BoardFile::load(argv[2]);
+      chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+      BoardFile::saveText(*board, cout);
+      cout << "# loaded in " << elapsed.count() << " us\n";
+    } else if ( (command == "catalog") && (argc == 3) ) {
+      BoardCatalog catalog(argv[2]);
+      for (const auto& entry : catalog.getAll()) {
+        cout << entry.first << ": " << entry.second->getSpaces().size() << " spaces\n";
+      }
+      for (const auto& error : catalog.getErrors()) {
+        cerr << "skipped " << error.first << ": " << error.second << "\n";
+      }
+    } else {
+      cerr << "usage: goose_board compile <layout> <binary>\n"
+              "       goose_board show <layout-or-binary>\n"
+              "       goose_board catalog <directory>" << endl;
+      return 1;
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+}
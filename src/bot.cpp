@@ -0,0 +1,44 @@
+#include "bot.hpp"
+#include "markov.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * ExpectationBot
+      */
+    ExpectationBot::ExpectationBot(std::shared_ptr<const Board> board) :
+        board(board), distances(MarkovSolver(board).solve().expectedTurnsFrom),
+        rerollDistances(distances.size(), 0.0) {
+        for (Board::size_type space = 0; space < this->board->getLastIndex(); ++space) {
+            double sum = 0.0;
+            for (Board::size_type first = 1; first <= 6; ++first) {
+                for (Board::size_type second = 1; second <= 6; ++second) {
+                    sum += distances[this->board->getMove(space, first + second).target];
+                }
+            }
+            rerollDistances[space] = sum / 36;
+        }
+    }
+
+    bool ExpectationBot::reroll(const Game& game, const PlayerSlot slot, const Board::size_type firstDice,
+                                const Board::size_type secondDice) const {
+        assert ( &game.getBoard() == board.get() );
+        const GamePlayers& players = game.getPlayers();
+        const Board::size_type position = players.getPosition(slot);
+        if ( game.hasWinner() || (position >= board->getLastIndex()) ) {
+            return false;
+        }
+
+        const Board::size_type target = board->getMove(position, firstDice + secondDice).target;
+        double keep = distances[target];
+        if ( (target != position) && (target != 0) ) {
+            PlayerSlot victim = players.findPlayerOnSpace(target, slot);
+            if (victim != GamePlayers::NO_SLOT) {
+                keep -= (distances[position] - distances[target]) / (players.size() - 1);
+            }
+        }
+        return keep > rerollDistances[position];
+    }
+  } // namespace core
+} // namespace goose_game
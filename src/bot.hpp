@@ -0,0 +1,42 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <memory>
+#include <vector>
+
+#include "core.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Keeps the dice when they lead to a space closer to the finish than a new
+      * throw would on average. Distances are the exact expected turns to finish
+      * of the MarkovSolver, so the one-throw lookahead sees every later turn.
+      * A prank counts for the turns it costs the victim, shared among the opponents.
+      */
+    class ExpectationBot : public Bot {
+        public:
+            explicit ExpectationBot(std::shared_ptr<const Board> board);
+
+            virtual bool reroll(const Game& game, const PlayerSlot slot, const Board::size_type firstDice,
+                                const Board::size_type secondDice) const;
+
+            // expected turns to finish from the space
+            inline double getDistance(const Board::size_type space) const {
+                return distances[space];
+            }
+
+            // expected distance after a throw from the space, pranks left aside
+            inline double getRerollDistance(const Board::size_type space) const {
+                return rerollDistances[space];
+            }
+        private:
+            std::shared_ptr<const Board> board;
+            std::vector<double> distances;
+            std::vector<double> rerollDistances;
+    };
+  } // namespace core
+} // namespace goose_game
+
+#endif //BOT_H
@@ -2,9 +2,13 @@
 #include <unordered_set>
 #include <string>
 #include <algorithm>
+#include <charconv>
 
 #include "mt.hpp"
 #include "core.hpp"
+#include "journal.hpp"
+#include "metrics.hpp"
+#include "static_board.hpp"
 
 using namespace std;
 
@@ -14,24 +18,46 @@ namespace goose_game {
     /**
       * Dice class
       */
-    Dice::Dice() : rd{}, mt{rd()}, dist{1, 6} {
+    Dice::Dice() : engine{mt::randomSeed()} {
     }
 
-    Dice::Dice(Dice&& other) : rd{}, mt{rd()}, dist{1, 6} {
+    Dice::Dice(std::uint64_t seed) : engine{seed} {
     }
 
+    void Dice::refill() {
+        std::uint64_t words[WORDS];
+        engine.fill(words, WORDS);
+        const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(words);
+        for (std::size_t i = 0; i < BUFFER_SIZE; ++i) {
+            // byte / 6 as a 16 bit multiply and shift, exact for any byte: the loop vectorizes
+            const std::uint16_t byte = bytes[i];
+            const std::uint16_t quotient = (byte * 171) >> 10;
+            faces[i] = (byte < 252) ? std::uint8_t(byte - quotient * 6 + 1) : 0;
+        }
+        next = 0;
+    }
+
+    unsigned int Dice::skip() {
+        std::uint8_t face = 0;
+        while (face == 0) {
+            if (next > BUFFER_SIZE) {
+                refill();
+            }
+            face = faces[next++];
+        }
+        return face;
+    }
 
-    /**
-      *  Board class
-      */
     Board::Board(const size_type size, const SpaceIndexesVector bridges, const SpaceIndexesVector gooses) {
         spaces.resize(size, NORMAL);
+        jumps.resize(size, 0);
 
         for (size_type index: bridges) {
             if ( index < size ) {
                 spaces[index] = BRIDGE;
+                jumps[index] = index + Consts::BRIDGE_SPACES_TO_ADVANCE;
             } else {
-                throw new invalid_argument("Bridges in Board constructor");
+                throw invalid_argument("Bridges in Board constructor");
             }
         }
 
@@ -39,22 +65,75 @@ namespace goose_game {
             if ( index < size ) {
                 spaces[index] = GOOSE;
             } else {
-                throw new invalid_argument("Gooses in Board constructor");
+                throw invalid_argument("Gooses in Board constructor");
             }
         }
 
-        spaces[getLastIndex()] = FINISH;
+        if (size > 0) {
+            spaces[getLastIndex()] = FINISH;
+        }
+        validate();
+        compileMoves();
     }
 
-    bool Board::isNormalPosition(const size_type position) const {
-        assert (position >= 0) ;
-        if (position > getLastIndex()) {
-            return false;
-        } else {
-            return (get(position) == NORMAL);
+    Board::Board(std::vector<std::uint8_t> spaces, std::vector<std::uint32_t> jumps) :
+        spaces(std::move(spaces)), jumps(std::move(jumps)) {
+        validate();
+        compileMoves();
+    }
+
+    Board::Board(std::vector<std::uint8_t> spaces, std::vector<std::uint32_t> jumps, std::vector<Move> moves) :
+        spaces(std::move(spaces)), jumps(std::move(jumps)), moves(std::move(moves)) {
+        validate();
+        if (this->moves.size() != this->spaces.size() * (MAX_DICE - MIN_DICE + 1)) {
+            throw invalid_argument("Moves in Board constructor");
+        }
+        for (const Move& move : this->moves) {
+            if (move.target > getLastIndex()) {
+                throw invalid_argument("Move target in Board constructor");
+            }
         }
     }
 
+    void Board::validate() const {
+        if ( (spaces.size() <= MAX_DICE) || (jumps.size() != spaces.size()) ) {
+            throw invalid_argument("Size in Board constructor");
+        }
+        if ( (spaces[0] != NORMAL) || (spaces[getLastIndex()] != FINISH) ) {
+            throw invalid_argument("Start or finish in Board constructor");
+        }
+        for (size_type index = 1; index < getLastIndex(); ++index) {
+            if ( (spaces[index] > DEATH) || (spaces[index] == FINISH) ) {
+                throw invalid_argument("Space type in Board constructor");
+            }
+            // Start is reached by a death space only
+            if ( (spaces[index] == BRIDGE) && ((jumps[index] == 0) || (jumps[index] > getLastIndex())) ) {
+                throw invalid_argument("Bridge target in Board constructor");
+            }
+        }
+    }
+
+    void Board::compileMoves() {
+        moves.reserve(spaces.size() * (MAX_DICE - MIN_DICE + 1));
+        for (size_type position = 0; position < spaces.size(); ++position) {
+            for (size_type dice = MIN_DICE; dice <= MAX_DICE; ++dice) {
+                Move move {0, 0, 0, 0, 0, false};
+                MoveRecorder recorder(move);
+                move.target = resolveMove(position, dice, recorder);
+                moves.push_back(move);
+            }
+        }
+    }
+
+    const std::shared_ptr<const Board>& Board::classic() {
+        static const std::shared_ptr<const Board> board = [] {
+            std::shared_ptr<Board> board = CLASSIC_BOARD.toBoard();
+            board->classicLayout = true;
+            return std::shared_ptr<const Board>(std::move(board));
+        }();
+        return board;
+    }
+
 
     /*
      * Player class
@@ -70,151 +149,608 @@ namespace goose_game {
      * Players class
      */
 
-    Players& Players::addPlayer(const Player& player) {
-    	if (!hasPlayer(player)) {
-    		collection.insert(player);
-    	} else {
-    		throw new invalid_argument("player in Players::addPlayer");
-    	}
-    	return *this;
+    Players::~Players() {
+        const PlayerId count = claimed.load();
+        for (PlayerId id = 0; id < count; ++id) {
+            if (slotOf(id).ready.load(std::memory_order_relaxed)) {
+                std::launder(reinterpret_cast<Player*>(slotOf(id).bytes))->~Player();
+            }
+        }
+        for (auto& segment : segments) {
+            delete[] segment.load();
+        }
+    }
+
+    PlayerId Players::addPlayer(const Player& player) {
+        const std::uint64_t hash = hashName(player.getName());
+        Shard& shard = shards[shardOf(hash)];
+        PlayerId id;
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.lock);
+            if (probe(shard, hash, player.getName()) != NO_PLAYER) {
+                return NO_PLAYER;
+            }
+            if (2 * (shard.count + 1) > shard.index.size()) {
+                rebuildIndex(shard, std::max<std::size_t>(16, 2 * shard.index.size()));
+            }
+            // the id is only taken once the name is known to be new: ids have no holes
+            id = claimed.fetch_add(1);
+            new (slotOf(id).bytes) Player(player);
+            slotOf(id).ready.store(true);
+            insert(shard, hash, id);
+            ++shard.count;
+        }
+        publish();
+        return id;
+    }
+
+    void Players::publish() {
+        // whoever stores the lowest missing player moves size() past every stored one;
+        // sequentially consistent, so of two neighbours stored at once one sees the other
+        PlayerId mark = published.load();
+        while ( (mark < claimed.load()) && slotOf(mark).ready.load() ) {
+            if (published.compare_exchange_weak(mark, mark + 1)) {
+                ++mark;
+            }
+        }
+    }
+
+    Players::Slot* Players::allocate(const std::uint32_t segment) const {
+        Slot* slots = new Slot[std::size_t(1) << (SEGMENT_BITS + segment)];
+        Slot* expected = nullptr;
+        if (!segments[segment].compare_exchange_strong(expected, slots)) {
+            delete[] slots;
+            return expected;
+        }
+        return slots;
+    }
+
+    void Players::reserve(const std::size_t count) {
+        // the players spread evenly over the shards, give or take a few
+        const std::size_t perShard = count / SHARD_COUNT + count / (4 * SHARD_COUNT) + 8;
+        std::size_t bucketCount = 16;
+        while (bucketCount < 2 * perShard) {
+            bucketCount *= 2;
+        }
+        for (Shard& shard : shards) {
+            std::unique_lock<std::shared_mutex> lock(shard.lock);
+            if (bucketCount > shard.index.size()) {
+                rebuildIndex(shard, bucketCount);
+            }
+        }
+    }
+
+    void Players::swap(Players& other) {
+        for (unsigned int segment = 0; segment < SEGMENT_COUNT; ++segment) {
+            segments[segment].store(other.segments[segment].exchange(segments[segment].load()));
+        }
+        claimed.store(other.claimed.exchange(claimed.load()));
+        published.store(other.published.exchange(published.load()));
+        for (unsigned int shard = 0; shard < SHARD_COUNT; ++shard) {
+            shards[shard].index.swap(other.shards[shard].index);
+            std::swap(shards[shard].count, other.shards[shard].count);
+        }
+        roster.swap(other.roster);
+        std::swap(rosterCount, other.rosterCount);
+    }
+
+    void Players::rebuildIndex(Shard& shard, const std::size_t bucketCount) {
+        std::vector<PlayerId> old(bucketCount, 0);
+        old.swap(shard.index);
+        for (PlayerId bucket : old) {
+            if (bucket != 0) {
+                insert(shard, hashName(get(bucket - 1).getName()), bucket - 1);
+            }
+        }
+    }
+
+    void Players::insert(Shard& shard, const std::uint64_t hash, const PlayerId id) {
+        const std::size_t mask = shard.index.size() - 1;
+        std::size_t bucket = hash & mask;
+        while (shard.index[bucket] != 0) {
+            bucket = (bucket + 1) & mask;
+        }
+        shard.index[bucket] = id + 1;
+    }
+
+    void Players::updateRoster() const {
+        for (const Player& player : getPage(rosterCount, size() - rosterCount)) {
+            if (rosterCount++ > 0) {
+                roster.append(", ");
+            }
+            roster.append(player.getName());
+        }
     }
 
     std::string Players::getAllPlayersAsString() const {
-         std::string comma = "";
-         std::string result = "";
+        std::lock_guard<std::mutex> lock(rosterLock);
+        updateRoster();
+        return roster;
+    }
 
-		     for (auto p : collection) {
-		 	       result.append(comma);
-		 	       result.append(p.getName());
-		 	       comma = ", ";
-		     }
+    void Players::writeAllPlayers(mt::Sink& out) const {
+        std::lock_guard<std::mutex> lock(rosterLock);
+        updateRoster();
+        out.write(roster.data(), roster.size());
+    }
 
-         return result;
+    void Players::writePlayers(mt::Sink& out, const PlayerId first, const PlayerId count) const {
+        std::string_view comma;
+        for (const Player& player : getPage(first, count)) {
+            out.write(comma.data(), comma.size());
+            out.write(player.getName().data(), player.getName().size());
+            comma = ", ";
+        }
     }
 
     /**
       * GamePlayer
       */
-    GamePlayer::GamePlayer(Game* game, const Player* player) : game(game), player(player), position {0} {
+    GamePlayer::GamePlayer(Game* game, const PlayerSlot slot) : game(game), slot(slot) {
     }
 
 
+    namespace {
+        // position as shown in the narration, formatted without allocating
+        class PositionText {
+            public:
+                explicit PositionText(const Board::size_type position) : position(position) {
+                    *std::to_chars(text, text + sizeof(text) - 1, position).ptr = '\0';
+                }
+
+                inline const char* c_str() const {
+                    return (position > 0) ? text : Messages::START.c_str();
+                }
+            private:
+                Board::size_type position;
+                char text[24];
+        };
+    }
+
+    /**
+      * Writes the narration of every step of a move
+      */
     std::string GamePlayer::moveBy(const Board::size_type firstDice, const Board::size_type secondDice) {
-        assert ( (firstDice > 0) && (firstDice <= 6) );
-        assert ( (secondDice > 0) && (secondDice <= 6) );
-        auto newPosition = position + firstDice + secondDice;
-        auto board = game->getBoard();
         std::string message;
-        message.append(mt::string_format(Messages::PLAYER_ROLLS, player->getName().c_str(), firstDice, secondDice));
-        message.append(getTextForTargetSpace(newPosition, false));
-        while ((!board.isNormalPosition(newPosition) && (!game->hasWinner()))) {
-            if (board.getLastIndex() >= newPosition) {
-                auto spaceType = board.get(newPosition);
-
-                if (spaceType == GOOSE) {
-                    newPosition += firstDice + secondDice;
-                    message.append(Messages::THE_GOOSE)
-                           .append(getTextForTargetSpace(newPosition, true));
-                } else if (spaceType == BRIDGE) {
-                    newPosition += Consts::BRIDGE_SPACES_TO_ADVANCE;
-                    message.append(mt::string_format(Messages::PLAYER_JUMPS_TO, player->getName().c_str(), newPosition));
-                } else {
-                    game->setWinner(*this);
-                    message.append(mt::string_format(Messages::PLAYER_WINS, player->getName().c_str()));
-                }
-            } else {
-                newPosition = board.getLastIndex() - (newPosition - board.getLastIndex());
-                message.append(mt::string_format(Messages::PLAYER_BOUNCE_TO, player->getName().c_str(), newPosition));
-            }
-        }
-        message.append(processPrank(position, newPosition));
-        position = newPosition;
+        mt::StringSink sink(message);
+        moveBy(firstDice, secondDice, sink);
         return message;
     }
 
-    std::string GamePlayer::processPrank(const Board::size_type oldPosition, const Board::size_type newPosition) {
-        if (newPosition != position) {
-            GamePlayer* colliding = game->findPlayerOnSpace(newPosition, this);
+    PlayerSlot GamePlayer::moveBy(const Board::size_type firstDice, const Board::size_type secondDice, mt::Sink& narration) {
+        MoveResult result = move(firstDice, secondDice);
+        GOOSE_TIME(NARRATION_RENDER);
+        game->getRenderer().render(*game, result, narration);
+        return result.pranked;
+    }
 
-            if (colliding != nullptr) {
-                colliding->forceMove(oldPosition);
-                return mt::string_format(Messages::PRANK, newPosition,
-                        colliding->getPlayer()->getName().c_str(), getPositionAsString(oldPosition).c_str());
+    MoveResult GamePlayer::move(const Board::size_type firstDice, const Board::size_type secondDice) {
+        assert ( (firstDice > 0) && (firstDice <= 6) );
+        assert ( (secondDice > 0) && (secondDice <= 6) );
+        GOOSE_TIME(MOVE_RESOLVE);
+        const Board::size_type position = getPosition();
+        MoveResult result {slot, GamePlayers::NO_SLOT, position,
+                static_cast<std::uint8_t>(firstDice), static_cast<std::uint8_t>(secondDice), game->hasWinner(), {}};
+
+        if (result.overtime) {
+            // the game is over: no more board rules apply
+            result.move.target = position + firstDice + secondDice;
+        } else {
+            const Board& board = game->getBoard();
+            result.move = board.isClassic() ? CLASSIC_BOARD.getMove(position, firstDice + secondDice)
+                                            : board.getMove(position, firstDice + secondDice);
+            if (result.move.wins) {
+                game->setWinner(slot);
             }
         }
+        result.pranked = processPrank(position, result.getTarget());
+        game->getPlayers().place(slot, result.getTarget());
+
+        GOOSE_COUNT(MOVES, 1);
+        GOOSE_COUNT(PRANKS, result.pranked != GamePlayers::NO_SLOT);
+        GOOSE_COUNT(GOOSE_HOPS, result.move.gooseHops);
+        GOOSE_COUNT(BRIDGES, result.move.bridges);
+        GOOSE_COUNT(BOUNCES, result.move.bounces);
+        GOOSE_COUNT(DEATHS, result.move.deaths);
+        GOOSE_COUNT(WINS, !result.overtime && result.move.wins);
+        return result;
+    }
 
-        return "";
+    PlayerSlot GamePlayer::processPrank(const Board::size_type oldPosition, const Board::size_type newPosition) {
+        // everybody may wait at Start: a player sent back there pranks nobody
+        if ( (newPosition == oldPosition) || (newPosition == 0) ) {
+            return GamePlayers::NO_SLOT;
+        }
+        GamePlayers& players = game->getPlayers();
+        PlayerSlot colliding = players.findPlayerOnSpace(newPosition, slot);
+
+        if (colliding != GamePlayers::NO_SLOT) {
+            players.place(colliding, oldPosition);
+        }
+        return colliding;
     }
 
-    std::string GamePlayer::getTextForTargetSpace(const Board::size_type newPosition, const bool again) {
-        auto board = game->getBoard();
-        auto index = std::min(board.getLastIndex(), newPosition);
-        auto spaceType = board.get(index);
-        std:string ret;
-        if (spaceType == BRIDGE) {
-            ret = mt::string_format(Messages::PLAYER_MOVES_TO_THE_BRIDGE, player->getName().c_str(), getPositionAsString(position).c_str());
-        } else if (again) {
-            ret = mt::string_format(Messages::PLAYER_MOVES_AGAIN_TO, player->getName().c_str(), index);
+
+    /**
+      * TextRenderer
+      */
+    const TextRenderer TextRenderer::INSTANCE;
+
+    template<class Layout>
+    class TextRenderer::Narrator : public MoveListener {
+        public:
+            Narrator(const Layout& board, const MoveResult& result, const char* name, mt::Sink& narration) :
+                board(board), from(result.from), name(name), narration(narration) {
+            }
+
+            inline void landsOn(const size_type position) {
+                writeTextForTargetSpace(position, false);
+            }
+
+            inline void goose(const size_type position) {
+                narration.write(Messages::THE_GOOSE);
+                writeTextForTargetSpace(position, true);
+            }
+
+            inline void bridge(const size_type position) {
+                mt::format_to(narration, Messages::PLAYER_JUMPS_TO, name, position);
+            }
+
+            inline void bounce(const size_type position) {
+                mt::format_to(narration, Messages::PLAYER_BOUNCE_TO, name, position);
+            }
+
+            inline void death(const size_type position) {
+                mt::format_to(narration, Messages::PLAYER_DIES, name);
+            }
+
+            inline void finish() {
+                mt::format_to(narration, Messages::PLAYER_WINS, name);
+            }
+        private:
+            void writeTextForTargetSpace(const size_type newPosition, const bool again) {
+                auto index = std::min(board.getLastIndex(), newPosition);
+                auto spaceType = board.get(index);
+                if (spaceType == BRIDGE) {
+                    mt::format_to(narration, Messages::PLAYER_MOVES_TO_THE_BRIDGE, name, PositionText(from).c_str());
+                } else if (again) {
+                    mt::format_to(narration, Messages::PLAYER_MOVES_AGAIN_TO, name, index);
+                } else {
+                    mt::format_to(narration, Messages::PLAYER_MOVES_FROM_TO, name, PositionText(from).c_str(), index);
+                }
+            }
+
+            const Layout& board;
+            size_type from;
+            const char* name;
+            mt::Sink& narration;
+    };
+
+    void TextRenderer::render(const Game& game, const MoveResult& result, mt::Sink& out) const {
+        if (game.getBoard().isClassic()) {
+            narrate(CLASSIC_BOARD, game, result, out);
         } else {
-            ret = mt::string_format(Messages::PLAYER_MOVES_FROM_TO, player->getName().c_str(), getPositionAsString(position).c_str(), index);
+            narrate(game.getBoard(), game, result, out);
         }
-        return ret;
+    }
+
+    template<class Layout>
+    void TextRenderer::narrate(const Layout& board, const Game& game, const MoveResult& result, mt::Sink& out) {
+        const GamePlayers& players = game.getPlayers();
+        Narrator<Layout> narrator(board, result, players.getPlayer(result.player).getName().c_str(), out);
+        mt::format_to(out, Messages::PLAYER_ROLLS, players.getPlayer(result.player).getName().c_str(), result.firstDice, result.secondDice);
 
+        if (result.overtime || result.move.isPlain()) {
+            narrator.landsOn(result.getTarget());
+        } else {
+            // walk the rules again, only to tell the story
+            board.resolveMove(result.from, result.firstDice + result.secondDice, narrator);
+        }
+        if (result.pranked != GamePlayers::NO_SLOT) {
+            mt::format_to(out, Messages::PRANK, result.getTarget(),
+                    players.getPlayer(result.pranked).getName().c_str(), PositionText(result.from).c_str());
+        }
     }
 
 
     /**
      *  GamePlayers
      */
-    GamePlayers::GamePlayers (Game* game, const Players& players) : game {game} {
-        for (auto& player : players.getAll()) {
-            gamePlayers.insert(collection_type::value_type(player.getName(),
-              GamePlayer{game,&player} ) );
+    GamePlayers::GamePlayers (const Board& board, const Players& players) : roster(players) {
+        reset(board);
+    }
+
+    GamePlayers::GamePlayers (const Board& board, const Players& players, const PlayerId* ids, const PlayerSlot count) :
+        roster(players) {
+        reset(board, ids, count);
+    }
+
+    PlayerSlot GamePlayers::findSlot(const PlayerId id) const {
+        auto iter = std::lower_bound(playerIds.begin(), playerIds.end(), id);
+        if ( (iter != playerIds.end()) && (*iter == id) ) {
+            return iter - playerIds.begin();
+        } else {
+            return NO_SLOT;
         }
     }
 
-    GamePlayer* GamePlayers::getPlayerByName(const std::string& name) {
-      auto iter = gamePlayers.find(name);
-      if ( iter != gamePlayers.end() ) {
-        GamePlayer* gp = &(*iter).second;
-        return gp;
-      } else {
-        return nullptr;
-      }
+    PlayerSlot GamePlayers::findSlot(std::string_view name) const {
+        PlayerId id = roster.findId(name);
+        return (id != Players::NO_PLAYER) ? findSlot(id) : NO_SLOT;
     }
 
-    GamePlayer* GamePlayers::findPlayerOnSpace (const Board::size_type space, const GamePlayer* playerToExclude) {
-        for (auto& pair : gamePlayers) {
-            if ( (&pair.second != playerToExclude) && (pair.second.getPosition()==space) ) {
-                return &pair.second;
+    PlayerSlot GamePlayers::findPlayerOnSpace (const Board::size_type space, const PlayerSlot slotToExclude) const {
+        if (isIndexed(space)) {
+            PlayerSlot occupant = occupants[space];
+            return (occupant != slotToExclude) ? occupant : NO_SLOT;
+        }
+
+        for (PlayerSlot slot = 0; slot < positions.size(); ++slot) {
+            if ( (slot != slotToExclude) && (positions[slot] == space) ) {
+                return slot;
+            }
+        }
+        return NO_SLOT;
+    }
+
+    void GamePlayers::place(const PlayerSlot slot, const Board::size_type space) {
+        // during a prank the space may already have been taken by the other player
+        if (isIndexed(positions[slot]) && (occupants[positions[slot]] == slot)) {
+            occupants[positions[slot]] = NO_SLOT;
+        }
+        positions[slot] = space;
+        if (isIndexed(space)) {
+            occupants[space] = slot;
+        }
+    }
+
+    void GamePlayers::reset(const Board& board) {
+        playerIds.resize(roster.size());
+        for (PlayerId id = 0; id < playerIds.size(); ++id) {
+            playerIds[id] = id;
+        }
+        positions.assign(playerIds.size(), 0);
+        occupants.assign(board.getLastIndex() + 1, NO_SLOT);
+    }
+
+    void GamePlayers::reset(const Board& board, const PlayerId* ids, const PlayerSlot count) {
+        playerIds.assign(ids, ids + count);
+        assert ( std::is_sorted(playerIds.begin(), playerIds.end()) );
+        positions.assign(count, 0);
+        occupants.assign(board.getLastIndex() + 1, NO_SLOT);
+    }
+
+    void GamePlayers::restore(const Board& board, const PlayerId* ids, const std::uint32_t* spaces, const PlayerSlot count) {
+        playerIds.assign(ids, ids + count);
+        positions.assign(spaces, spaces + count);
+        occupants.assign(board.getLastIndex() + 1, NO_SLOT);
+        for (PlayerSlot slot = 0; slot < count; ++slot) {
+            assert ( playerIds[slot] < roster.size() );
+            assert ( (slot == 0) || (playerIds[slot - 1] < playerIds[slot]) );
+            if (isIndexed(positions[slot])) {
+                occupants[positions[slot]] = slot;
             }
         }
-        return nullptr;
     }
 
     /**
       * Game
       */
-    Game::Game(const Players& players) :  players(this, players), board {Consts::SPACE_COUNT, Consts::BRIDGES, Consts::GOOSES} {
+    Game::Game(const Players& players) : Game(players, Board::classic()) {
+    }
+
+    Game::Game(const Players& players, std::shared_ptr<const Board> board) :
+        board {std::move(board)}, players(*this->board, players) {
     }
 
-    Game::Game(Game&& other) : players (other.players), board(other.board) {
+    Game::Game(const Players& players, const PlayerId* ids, const PlayerSlot count) :
+        board {Board::classic()}, players(*this->board, players, ids, count) {
+    }
+
+    Game::Game(Game&& other) : board(other.board), players (other.players), winner(other.winner),
+        dice(std::move(other.dice)), renderer(other.renderer), journal(other.journal), journalGame(other.journalGame) {
+        other.journal = nullptr;
+    }
+
+    Game& Game::reset() {
+        players.reset(*board);
+        winner = GamePlayers::NO_SLOT;
+        return *this;
+    }
+
+    Game& Game::reset(const PlayerId* ids, const PlayerSlot count) {
+        players.reset(*board, ids, count);
+        winner = GamePlayers::NO_SLOT;
+        return *this;
+    }
+
+    Game& Game::restore(const PlayerId* ids, const std::uint32_t* spaces, const PlayerSlot count, const PlayerSlot winner) {
+        players.restore(*board, ids, spaces, count);
+        this->winner = winner;
+        return *this;
     }
 
     std::string Game::movePlayer(const std::string& name, Board::size_type firstDice, Board::size_type secondDice) {
+      std::string message;
+      mt::StringSink sink(message);
+      movePlayer(name, firstDice, secondDice, sink);
+      return message;
+    }
+
+    std::string Game::moveThrowingDice(const std::string& playerName) {
+      const auto firstDice = dice.roll();
+      return movePlayer(playerName, firstDice, dice.roll());
+    }
+
+    void Game::movePlayer(std::string_view name, Board::size_type firstDice, Board::size_type secondDice, mt::Sink& narration) {
       assert ( !name.empty() );
-      assert ( (firstDice > 0) && (firstDice <= 6) );
-      assert ( (secondDice > 0) && (secondDice <= 6) );
-      GamePlayer* player = players.getPlayerByName(name);
-      if (player != nullptr) {
-          return player->moveBy(firstDice, secondDice);
+      PlayerSlot slot = players.findSlot(name);
+      if (slot != GamePlayers::NO_SLOT) {
+          movePlayer(slot, firstDice, secondDice, narration);
       } else {
-          return mt::string_format(Messages::UNKNOWN_PLAYER, name.c_str());
+          mt::format_to(narration, Messages::UNKNOWN_PLAYER, static_cast<int>(name.size()), name.data());
       }
     }
 
-    std::string Game::moveThrowingDice(const std::string& playerName) {
-      return movePlayer(playerName, dice1.roll(), dice2.roll());
+    void Game::moveThrowingDice(std::string_view playerName, mt::Sink& narration) {
+      const auto firstDice = dice.roll();
+      movePlayer(playerName, firstDice, dice.roll(), narration);
+    }
+
+    void Game::movePlayer(const PlayerSlot slot, Board::size_type firstDice, Board::size_type secondDice, mt::Sink& narration) {
+      MoveResult result = move(slot, firstDice, secondDice);
+      GOOSE_TIME(NARRATION_RENDER);
+      renderer->render(*this, result, narration);
+    }
+
+    MoveResult Game::move(const PlayerSlot slot, Board::size_type firstDice, Board::size_type secondDice) {
+      assert ( slot < players.size() );
+      MoveResult result = GamePlayer(this, slot).move(firstDice, secondDice);
+      if (journal != nullptr) {
+          journal->movePlayer(journalGame, slot, firstDice, secondDice, result.getTarget(), result.pranked,
+                              !result.overtime && result.move.wins);
+      }
+      return result;
+    }
+
+    MoveResult Game::move(const PlayerSlot slot) {
+      const auto firstDice = dice.roll();
+      return move(slot, firstDice, dice.roll());
+    }
+
+    MoveResult Game::move(const PlayerSlot slot, const Bot& bot) {
+      auto firstDice = dice.roll();
+      auto secondDice = dice.roll();
+      if (bot.reroll(*this, slot, firstDice, secondDice)) {
+          firstDice = dice.roll();
+          secondDice = dice.roll();
+      }
+      return move(slot, firstDice, secondDice);
+    }
+
+    void Game::setJournal(Journal* journal) {
+      if (this->journal != nullptr) {
+          this->journal->endGame(journalGame);
+      }
+      this->journal = journal;
+      if (journal != nullptr) {
+          journalGame = journal->startGame(players);
+          // a restored game is not at Start: its positions are logged as moves without dice
+          for (PlayerSlot slot = 0; slot < players.size(); ++slot) {
+              if ( (players.getPosition(slot) != 0) || (slot == winner) ) {
+                  journal->movePlayer(journalGame, slot, 0, 0, players.getPosition(slot), GamePlayers::NO_SLOT,
+                                      slot == winner);
+              }
+          }
+      }
+    }
+
+    void Game::moveThrowingDice(const PlayerSlot slot, mt::Sink& narration) {
+      const auto firstDice = dice.roll();
+      movePlayer(slot, firstDice, dice.roll(), narration);
+    }
+
+    /**
+      * GamePool
+      */
+    GamePool::GamePool(const Players& players, std::size_t capacity, Journal* journal) :
+        players(players), journal(journal) {
+        available.reserve(capacity);
+        while (games.size() < capacity) {
+            games.emplace_back(players, nullptr, 0);
+            available.push_back(&games.back());
+        }
+    }
+
+    GamePool::handle_type GamePool::acquire() {
+        Game* game = take();
+        game->reset();
+        if (journal != nullptr) {
+            game->setJournal(journal);
+        }
+        return handle_type(game, Releaser(this));
+    }
+
+    GamePool::handle_type GamePool::acquire(const PlayerId* ids, const PlayerSlot count) {
+        Game* game = take();
+        game->reset(ids, count);
+        if (journal != nullptr) {
+            game->setJournal(journal);
+        }
+        return handle_type(game, Releaser(this));
+    }
+
+    GamePool::handle_type GamePool::acquire(const PlayerId* ids, const std::uint32_t* spaces, const PlayerSlot count,
+                                            const PlayerSlot winner) {
+        Game* game = take();
+        game->restore(ids, spaces, count, winner);
+        if (journal != nullptr) {
+            game->setJournal(journal);
+        }
+        return handle_type(game, Releaser(this));
+    }
+
+    Game* GamePool::take() {
+        if (available.empty()) {
+            games.emplace_back(players, nullptr, 0);
+            return &games.back();
+        }
+        Game* game = available.back();
+        available.pop_back();
+        return game;
+    }
+
+    void GamePool::release(Game* game) {
+        game->setJournal(nullptr);
+        available.push_back(game);
+    }
+
+    std::vector<const Game*> GamePool::getActive() const {
+        std::vector<const Game*> idle(available.begin(), available.end());
+        std::sort(idle.begin(), idle.end());
+        std::vector<const Game*> active;
+        for (const Game& game : games) {
+            if (!std::binary_search(idle.begin(), idle.end(), &game)) {
+                active.push_back(&game);
+            }
+        }
+        return active;
+    }
+
+    /**
+      * App
+      */
+    std::string App::addPlayer(const std::string& name) {
+        PlayerId id = players->addPlayer(Player(name));
+        if (shared) {
+            if (id == Players::NO_PLAYER) {
+                id = players->findId(name);
+            }
+            auto iter = std::lower_bound(members.begin(), members.end(), id);
+            if ( (iter != members.end()) && (*iter == id) ) {
+                id = Players::NO_PLAYER;
+            } else {
+                members.insert(iter, id);
+            }
+        }
+        if (id == Players::NO_PLAYER) {
+            return mt::string_format(Messages::ALREADY_EXISTING_PLAYER, name.c_str());
+        }
+        return mt::string_format(Messages::PLAYER_ADDED, name.c_str());
+    }
+
+    void App::writePlayers(mt::Sink& out, const PlayerId first, const PlayerId count) const {
+        if (!shared) {
+            players->writePlayers(out, first, count);
+            return;
+        }
+        std::string_view comma;
+        for (std::size_t index = first; (index < members.size()) && (index - first < count); ++index) {
+            const std::string& name = players->get(members[index]).getName();
+            out.write(comma.data(), comma.size());
+            out.write(name.data(), name.size());
+            comma = ", ";
+        }
     }
   } // core
 } // goose_game
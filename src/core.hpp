@@ -1,85 +1,301 @@
 #ifndef CORE_H
 #define CORE_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <deque>
+#include <limits>
 #include <iostream>
-#include <unordered_set>
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <stdexcept>
 #include <vector>
 #include <random>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "mt.hpp"
+#include "rng.hpp"
 
 namespace goose_game {
   namespace core {
 
+    /**
+      * A six-sided die reading faces from a buffer, refilled in bulk from
+      * Xoshiro256x4 output: every byte below 252 gives the face 1 + byte % 6,
+      * the others are left as 0 and skipped, so faces are unbiased.
+      */
     class Dice {
         public:
             Dice();
 
-            Dice(Dice&& other);
+            explicit Dice(std::uint64_t seed);
+
+            inline void seed(std::uint64_t seed) {
+                engine.seed(seed);
+                next = BUFFER_SIZE;
+            }
 
             inline unsigned int roll() {
-                return dist(mt);
+                const std::uint8_t face = faces[next++];
+                return (face != 0) ? face : skip();
             };
         private:
-            std::random_device rd;
-            std::mt19937 mt;
-            std::uniform_int_distribution<int> dist;
+            static constexpr std::size_t WORDS = 32;
+            static constexpr std::size_t BUFFER_SIZE = WORDS * sizeof(std::uint64_t);
+
+            // past a rejected byte or the end of the buffer
+            unsigned int skip();
+            void refill();
+
+            mt::Xoshiro256x4 engine;
+            std::size_t next = BUFFER_SIZE;
+            // one more face, always 0, marks the end of the buffer
+            alignas(32) std::uint8_t faces[BUFFER_SIZE + 1] = {};
     };
 
-    enum SpaceType {
+    enum SpaceType : std::uint8_t {
         NORMAL,
         BRIDGE,
         GOOSE,
-        FINISH
+        FINISH,
+        DEATH
     };
 
     typedef std::vector<SpaceType> SpaceTypeVector;
     typedef std::vector<SpaceTypeVector::size_type> SpaceIndexesVector;
 
-    class Board  {
+    /**
+      * Receives the steps of a move resolved by Board::resolveMove.
+      * The default handlers do nothing: derive and hide the ones you need.
+      */
+    struct MoveListener {
+        typedef SpaceTypeVector::size_type size_type;
+
+        constexpr void landsOn(const size_type position) {};
+        constexpr void goose(const size_type position) {};
+        constexpr void bridge(const size_type position) {};
+        constexpr void bounce(const size_type position) {};
+        constexpr void death(const size_type position) {};
+        constexpr void finish() {};
+    };
+
+    /**
+      * Immutable board layout, one byte per space.
+      * Boards are not copyable: games with the same layout share one instance.
+      */
+    class Board : private mt::NonAssignable {
         public:
             typedef SpaceTypeVector::size_type size_type;
 
+            static constexpr size_type MIN_DICE = 2;
+            static constexpr size_type MAX_DICE = 12;
+
+            /**
+              * Outcome of a move, precomputed for every position and dice sum
+              */
+            struct Move {
+                std::uint32_t target;
+                std::uint8_t gooseHops;
+                std::uint8_t bridges;
+                std::uint8_t bounces;
+                std::uint8_t deaths;
+                bool wins;
+
+                // no space rule applies: the player just moves by the dice
+                constexpr bool isPlain() const {
+                    return (gooseHops == 0) && (bridges == 0) && (bounces == 0) && (deaths == 0) && !wins;
+                }
+            };
+
+            // bridges jump forward by Consts::BRIDGE_SPACES_TO_ADVANCE
             Board(const size_type size, const SpaceIndexesVector bridges, const SpaceIndexesVector gooses);
 
+            // one SpaceType per space, and the target of every BRIDGE space in jumps
+            Board(std::vector<std::uint8_t> spaces, std::vector<std::uint32_t> jumps);
+
+            // as above, with the move table already compiled (see BoardFile)
+            Board(std::vector<std::uint8_t> spaces, std::vector<std::uint32_t> jumps, std::vector<Move> moves);
+
+            // the shared board with the standard layout of Consts
+            static const std::shared_ptr<const Board>& classic();
+
+            // the board of classic(): hot paths take its moves from the constant CLASSIC_BOARD instead
+            inline bool isClassic() const {
+                return classicLayout;
+            }
+
             inline SpaceType get(const size_type position) const {
                 //here I know that size_type cannot be negative, but is it right to assume this here?
-                assert ( position <= spaces.size() );
+                assert ( position < spaces.size() );
 
-                return spaces[position];
+                return static_cast<SpaceType>(spaces[position]);
             }
 
             inline size_type getLastIndex() const {
                 return spaces.size()-1;
             }
 
-            bool isNormalPosition(const size_type position) const;
+            inline bool isNormalPosition(const size_type position) const {
+                return (position <= getLastIndex()) && (spaces[position] == NORMAL);
+            }
+
+            inline size_type getJump(const size_type position) const {
+                assert ( position < jumps.size() );
+                return jumps[position];
+            }
+
+            inline const std::vector<std::uint8_t>& getSpaces() const {
+                return spaces;
+            }
+
+            inline const std::vector<std::uint32_t>& getJumps() const {
+                return jumps;
+            }
+
+            inline const std::vector<Move>& getMoves() const {
+                return moves;
+            }
+
+            /**
+              * Applies the board rules (goose, bridge, death, bounce, finish) to a
+              * player moving by dice from position and returns the final position.
+              */
+            template<class Listener>
+            size_type resolveMove(size_type position, const size_type dice, Listener& listener) const;
+
+            // table lookup of the outcome of resolveMove
+            inline const Move& getMove(const size_type position, const size_type dice) const {
+                assert ( position <= getLastIndex() );
+                assert ( (dice >= MIN_DICE) && (dice <= MAX_DICE) );
+                return moves[position * (MAX_DICE - MIN_DICE + 1) + dice - MIN_DICE];
+            }
+        private:
+            void validate() const;
+            void compileMoves();
+
+            std::vector<std::uint8_t> spaces;
+            std::vector<std::uint32_t> jumps;
+            std::vector<Move> moves;
+            bool classicLayout = false;
+    };
+
+    /**
+      * Counts the steps of a move into a Board::Move
+      */
+    class MoveRecorder : public MoveListener {
+        public:
+            // a move applying more rules than this is taken as endless
+            static constexpr unsigned int MAX_STEPS = 255;
+
+            constexpr explicit MoveRecorder(Board::Move& move) : move(move) {
+            }
+
+            constexpr void goose(const size_type position) {
+                ++move.gooseHops;
+                count();
+            }
+
+            constexpr void bridge(const size_type position) {
+                ++move.bridges;
+                count();
+            }
+
+            constexpr void bounce(const size_type position) {
+                ++move.bounces;
+                count();
+            }
+
+            constexpr void death(const size_type position) {
+                ++move.deaths;
+                count();
+            }
+
+            constexpr void finish() {
+                move.wins = true;
+            }
         private:
-            std::vector<SpaceType> spaces;
+            constexpr void count() {
+                if (++steps > MAX_STEPS) {
+                    throw std::invalid_argument("Endless move in Board");
+                }
+            }
+
+            Board::Move& move;
+            unsigned int steps = 0;
     };
 
     class Consts final {
       public:
-        static const Board::size_type BRIDGE_SPACES_TO_ADVANCE = 6;
-        static const Board::size_type SPACE_COUNT = 64;
-        static inline const SpaceIndexesVector BRIDGES = {6};
-        static inline const SpaceIndexesVector GOOSES = {5,9,14,18,23,27};
+        static constexpr Board::size_type BRIDGE_SPACES_TO_ADVANCE = 6;
+        static constexpr Board::size_type SPACE_COUNT = 64;
+        // constant, so that ClassicBoard is built from them at compile time
+        static constexpr std::array<std::uint32_t, 1> BRIDGE_SPACES = {6};
+        static constexpr std::array<std::uint32_t, 6> GOOSE_SPACES = {5,9,14,18,23,27};
+        static inline const SpaceIndexesVector BRIDGES {BRIDGE_SPACES.begin(), BRIDGE_SPACES.end()};
+        static inline const SpaceIndexesVector GOOSES {GOOSE_SPACES.begin(), GOOSE_SPACES.end()};
         static inline const std::string ADD_PLAYER_COMMAND = "add player";
         static inline const std::string EXIT_COMMAND = "exit";
         static inline const std::string PLAY_COMMAND = "play";
         static inline const std::string MOVE_PLAYER_COMMAND = "move";
+        static inline const std::string LIST_PLAYERS_COMMAND = "players";
+        static constexpr unsigned int PLAYERS_PAGE_SIZE = 100;
+        // only in builds with GOOSE_METRICS (see metrics.hpp)
+        static inline const std::string METRICS_COMMAND = "metrics";
     };
 
+    /**
+      * The rule walk behind Board::resolveMove, for any layout with the
+      * accessors of Board: StaticBoard runs it at compile time.
+      */
+    template<class Layout, class Listener>
+    constexpr typename Layout::size_type walkMove(const Layout& layout, typename Layout::size_type position,
+            const typename Layout::size_type dice, Listener& listener) {
+        position += dice;
+        listener.landsOn(position);
+        while (!layout.isNormalPosition(position)) {
+            if (layout.getLastIndex() >= position) {
+                auto spaceType = layout.get(position);
+
+                if (spaceType == GOOSE) {
+                    position += dice;
+                    listener.goose(position);
+                } else if (spaceType == BRIDGE) {
+                    position = layout.getJump(position);
+                    listener.bridge(position);
+                } else if (spaceType == DEATH) {
+                    position = 0;
+                    listener.death(position);
+                } else {
+                    listener.finish();
+                    break;
+                }
+            } else {
+                position = layout.getLastIndex() - (position - layout.getLastIndex());
+                listener.bounce(position);
+            }
+        }
+        return position;
+    }
+
+    template<class Listener>
+    Board::size_type Board::resolveMove(size_type position, const size_type dice, Listener& listener) const {
+        return walkMove(*this, position, dice, listener);
+    }
+
       class Messages final {
       public:
         static inline const std::string APP_MENU =
                 "\n"
                 "==Goose Game App Commands==\n"
                 " add player <player-name>\n"
+                " players [<page>]\n"
                 " play\n"
                 " exit\n"
                 "Please input your command";
@@ -96,18 +312,20 @@ namespace goose_game {
         static inline const std::string ALREADY_EXISTING_PLAYER = "%s: already existing player\n";
         static inline const std::string PLAYERS = "players: %s\n";
         static inline const std::string UNKNOWN_COMMAND = "Unknown command\n";
-        static inline const std::string UNKNOWN_PLAYER = "Unknown player %s\n";
+        static inline const std::string UNKNOWN_PLAYER = "Unknown player %.*s\n";
         static inline const std::string PLAYER_NAME_IS_REQUIRED = "Player's name is required\n";
         static inline const std::string BYE = "Bye Bye\n";
         static inline const std::string GAME_QUITTED = "Game quitted\n";
         static inline const std::string NO_PLAYERS = "No players for the game\n";
-        static inline const std::string INVALID_DICE_ARG = "Invalid dice argument: %s\n";
+        static inline const std::string INVALID_DICE_ARG = "Invalid dice argument: %.*s\n";
+        static inline const std::string INVALID_PAGE = "Invalid page: %.*s\n";
         static inline const std::string START = "Start";
         static inline const std::string PLAYER_MOVES_FROM_TO = "%s moves from %s to %d";
         static inline const std::string PLAYER_MOVES_AGAIN_TO = ". %s moves again and goes to %d";
         static inline const std::string PLAYER_JUMPS_TO = ". %s jumps to %d";
         static inline const std::string PLAYER_MOVES_TO_THE_BRIDGE = "%s moves from %s to The Bridge";
         static inline const std::string PLAYER_BOUNCE_TO = ". %1$s bounces! %1$s returns to %2$d";
+        static inline const std::string PLAYER_DIES = ". %1$s dies! %1$s returns to Start";
         static inline const std::string PLAYER_ROLLS = "%s rolls %d, %d. ";
         static inline const std::string PLAYER_WINS = ". %s Wins!\n";
         static inline const std::string MOVE_PLAYER_NAME_IS_REQUIRED = "Command Move: Player's name is required\n";
@@ -133,154 +351,575 @@ namespace goose_game {
 
     bool operator == (const Player& left, const Player& right);
 
-    struct PlayerHashFunction {
-      std::size_t operator()(const Player& p) const {
-        std::hash<std::string> hashVal;
-        return hashVal(p.getName());
-      }
-    };
-
-    class Players  {
+    typedef std::uint32_t PlayerId;    // index of a player in Players
+    typedef std::uint32_t PlayerSlot;  // index of a player in a Game
+
+    /**
+      * Registry of the players. Every name is stored once and gets a dense id;
+      * players are never moved, so references and ids stay valid.
+      * Players can be added from any number of threads at once. Names are found
+      * through SHARD_COUNT open addressing indexes of the ids, each behind a lock
+      * of its own, and the players are stored in segments that never move.
+      * size() only counts the players whose lower ids are all stored too, so
+      * the ids below it are a consistent snapshot of the registry.
+      */
+    class Players : private mt::NonAssignable {
       public:
-        typedef std::unordered_set<Player, PlayerHashFunction> collection_type;
+        static constexpr PlayerId NO_PLAYER = std::numeric_limits<PlayerId>::max();
+        static constexpr unsigned int SHARD_BITS = 6;
+        static constexpr unsigned int SHARD_COUNT = 1u << SHARD_BITS;
+
+        /**
+          * The players with ids in [begin, end), none above the size of the registry when it was taken
+          */
+        class Range {
+          public:
+            class iterator {
+              public:
+                inline iterator(const Players* players, const PlayerId id) : players(players), id(id) {};
+                inline const Player& operator*() const {
+                    return players->get(id);
+                };
+                inline iterator& operator++() {
+                    ++id;
+                    return *this;
+                };
+                inline bool operator!=(const iterator& other) const {
+                    return id != other.id;
+                };
+              private:
+                const Players* players;
+                PlayerId id;
+            };
 
-        Players& addPlayer(const Player& player);
+            inline Range(const Players* players, const PlayerId first, const PlayerId last) :
+                players(players), first(first), last(last) {};
+            inline iterator begin() const {
+                return iterator(players, first);
+            };
+            inline iterator end() const {
+                return iterator(players, last);
+            };
+            inline PlayerId size() const {
+                return last - first;
+            };
+          private:
+            const Players* players;
+            PlayerId first;
+            PlayerId last;
+        };
+
+        Players() = default;
+        ~Players();
+
+        // the id of the new player, or NO_PLAYER when the name is taken already
+        PlayerId addPlayer(const Player& player);
+
+        // room for count players without growing the name indexes
+        void reserve(const std::size_t count);
+
+        // exchanges all the players with the other registry. Not thread safe
+        void swap(Players& other);
+
+        /**
+          * Appends count players, nameAt(id) giving their names, with indexes
+          * built for exactly those names by getIndex(): no name is hashed again.
+          * Shard s holds the buckets [shardOffsets[s], shardOffsets[s + 1]).
+          * Not thread safe.
+          */
+        template<class NameAt>
+        void restore(const PlayerId count, NameAt&& nameAt, const PlayerId* buckets, const std::uint64_t* shardOffsets) {
+          assert ( size() == 0 );
+          for (PlayerId id = 0; id < count; ++id) {
+            new (slotOf(id).bytes) Player(std::string(nameAt(id)));
+            slotOf(id).ready.store(true, std::memory_order_relaxed);
+          }
+          for (unsigned int shard = 0; shard < SHARD_COUNT; ++shard) {
+            shards[shard].index.assign(buckets + shardOffsets[shard], buckets + shardOffsets[shard + 1]);
+            shards[shard].count = std::count_if(shards[shard].index.begin(), shards[shard].index.end(),
+                                                [](PlayerId bucket) { return bucket != 0; });
+          }
+          claimed.store(count);
+          published.store(count);
+        };
 
         inline bool isEmpty() const {
-          return collection.empty();
+          return size() == 0;
         };
 
         inline bool hasPlayer (const Player& player) const {
-          return (collection.count(player) == 1);
+          return findId(player.getName()) != NO_PLAYER;
+        };
+
+        // may find a player still being added, with an id not below size() yet
+        inline PlayerId findId(std::string_view name) const {
+          const std::uint64_t hash = hashName(name);
+          const Shard& shard = shards[shardOf(hash)];
+          std::shared_lock<std::shared_mutex> lock(shard.lock);
+          return probe(shard, hash, name);
         };
 
-        inline auto getAll() const {
-          return mt::const_range<collection_type>(&collection);
+        inline const Player& get(const PlayerId id) const {
+          assert ( id < claimed.load(std::memory_order_relaxed) );
+          return *std::launder(reinterpret_cast<const Player*>(slotOf(id).bytes));
         };
 
+        inline PlayerId size() const {
+          return published.load(std::memory_order_acquire);
+        };
+
+        inline Range getAll() const {
+          return Range(this, 0, size());
+        };
+
+        // at most count players from the id first on: the cost is the page, whatever the roster
+        inline Range getPage(const PlayerId first, const PlayerId count) const {
+          const PlayerId total = size();
+          const PlayerId begin = std::min(first, total);
+          return Range(this, begin, begin + std::min(count, total - begin));
+        };
+
+        // buckets hold a player id + 1, or 0 when empty; their count is 0 or a power of 2.
+        // Not thread safe: no player may be added meanwhile
+        inline const std::vector<PlayerId>& getIndex(const unsigned int shard) const {
+          return shards[shard].index;
+        };
+
+        // FNV-1a
+        static inline std::uint64_t hashName(std::string_view name) {
+          std::uint64_t hash = 0xcbf29ce484222325ULL;
+          for (unsigned char c : name) {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+          }
+          return hash;
+        };
+
+        // the high bits pick the shard, the low ones the first bucket
+        static inline unsigned int shardOf(const std::uint64_t hash) {
+          return hash >> (64 - SHARD_BITS);
+        };
+
+        // the names comma separated, in id order, from a cache extended with the players added since the last call:
+        // addPlayer never touches it, so registrations do not wait on one another
         std::string getAllPlayersAsString() const;
+        void writeAllPlayers(mt::Sink& out) const;
+
+        // the names of getPage(first, count), comma separated
+        void writePlayers(mt::Sink& out, const PlayerId first, const PlayerId count) const;
       private:
-        collection_type collection;
+        // a small first segment: a registry of a few players costs a few slots
+        static constexpr unsigned int SEGMENT_BITS = 4;
+        static constexpr unsigned int SEGMENT_COUNT = 32;
+
+        struct Slot {
+          alignas(Player) unsigned char bytes[sizeof(Player)];
+          std::atomic<bool> ready {false};
+        };
+
+        struct alignas(64) Shard {
+          mutable std::shared_mutex lock;
+          std::vector<PlayerId> index;
+          PlayerId count = 0;
+        };
+
+        // segment k holds 2^(SEGMENT_BITS + k) players, allocated on first use
+        inline Slot& slotOf(const PlayerId id) const {
+          const std::uint32_t segment = 31 - __builtin_clz((id >> SEGMENT_BITS) + 1);
+          const PlayerId first = ((PlayerId(1) << segment) - 1) << SEGMENT_BITS;
+          Slot* slots = segments[segment].load(std::memory_order_acquire);
+          if (slots == nullptr) {
+            slots = allocate(segment);
+          }
+          return slots[id - first];
+        };
+
+        inline PlayerId probe(const Shard& shard, const std::uint64_t hash, std::string_view name) const {
+          if (shard.index.empty()) {
+            return NO_PLAYER;
+          }
+          const std::size_t mask = shard.index.size() - 1;
+          for (std::size_t bucket = hash & mask; shard.index[bucket] != 0; bucket = (bucket + 1) & mask) {
+            if (get(shard.index[bucket] - 1).getName() == name) {
+              return shard.index[bucket] - 1;
+            }
+          }
+          return NO_PLAYER;
+        };
+
+        Slot* allocate(const std::uint32_t segment) const;
+        void rebuildIndex(Shard& shard, const std::size_t bucketCount);
+        void insert(Shard& shard, const std::uint64_t hash, const PlayerId id);
+        // moves size() past every player stored with no gap below it
+        void publish();
+        // appends the players added since the last call to the roster; rosterLock must be held
+        void updateRoster() const;
+
+        mutable std::atomic<Slot*> segments[SEGMENT_COUNT] = {};
+        std::atomic<PlayerId> claimed {0};
+        std::atomic<PlayerId> published {0};
+        Shard shards[SHARD_COUNT];
+
+        mutable std::mutex rosterLock;
+        mutable std::string roster;
+        mutable PlayerId rosterCount = 0;
     };
 
 
     class Game;
     class GamePlayers;
+    class Journal;
+
+    /**
+      * What a move did, with no text: a MoveRenderer tells it when asked
+      */
+    struct MoveResult {
+        PlayerSlot player;
+        // the player sent back to from by a prank, or GamePlayers::NO_SLOT
+        PlayerSlot pranked;
+        Board::size_type from;
+        std::uint8_t firstDice;
+        std::uint8_t secondDice;
+        // the game was already won: no board rules applied
+        bool overtime;
+        Board::Move move;
+
+        inline Board::size_type getTarget() const {
+            return move.target;
+        }
+    };
 
-    class GamePlayer {
+    /**
+      * Turns move results into text: narration, other languages, JSON...
+      */
+    class MoveRenderer {
         public:
-            GamePlayer(Game* game, const Player* player);
+            virtual ~MoveRenderer() {};
+            // called right after the move, before any other move of the game
+            virtual void render(const Game& game, const MoveResult& result, mt::Sink& out) const = 0;
+    };
 
-            std::string moveBy(const Board::size_type firstDice, const Board::size_type secondDice);
+    /**
+      * The English narration of the Messages templates
+      */
+    class TextRenderer : public MoveRenderer {
+        public:
+            static const TextRenderer INSTANCE;
 
-            inline Board::size_type getPosition() const {
-                return position;
-            }
+            virtual void render(const Game& game, const MoveResult& result, mt::Sink& out) const;
+        private:
+            template<class Layout>
+            class Narrator;
 
-            inline const Player* getPlayer() const {
-                return player;
-            }
+            template<class Layout>
+            static void narrate(const Layout& layout, const Game& game, const MoveResult& result, mt::Sink& out);
+    };
 
-        private:
+    /**
+      * Decides the turns of the players it is given, under the house rule of
+      * Game::move(slot, bot): once per turn a player may throw the dice again,
+      * and then has to keep the second throw. Decisions must not change the
+      * bot, so one bot can play any number of games at once.
+      */
+    class Bot {
+        public:
+            virtual ~Bot() {};
+            virtual bool reroll(const Game& game, const PlayerSlot slot, const Board::size_type firstDice,
+                                const Board::size_type secondDice) const = 0;
+    };
 
-            inline GamePlayer& forceMove(const Board::size_type newPos) {
-                position = newPos;
-                return *this;
-            }
+    /**
+      * Handle to a player sitting in a game
+      */
+    class GamePlayer {
+        public:
+            GamePlayer(Game* game, const PlayerSlot slot);
+
+            // applies the move and the prank, without any text
+            MoveResult move(const Board::size_type firstDice, const Board::size_type secondDice);
+
+            std::string moveBy(const Board::size_type firstDice, const Board::size_type secondDice);
+            // returns the slot of the player sent back by a prank, or GamePlayers::NO_SLOT
+            PlayerSlot moveBy(const Board::size_type firstDice, const Board::size_type secondDice, mt::Sink& narration);
+
+            Board::size_type getPosition() const;
+            const Player* getPlayer() const;
 
-            inline std::string getPositionAsString(const Board::size_type position) const {
-                return (position > 0) ? std::to_string(position) : Messages::START;
+            inline PlayerSlot getSlot() const {
+                return slot;
             }
 
-            std::string processPrank(const Board::size_type oldPosition, const Board::size_type newPosition);
-            std::string getTextForTargetSpace(const Board::size_type newPosition, const bool again);
+        private:
+            PlayerSlot processPrank(const Board::size_type oldPosition, const Board::size_type newPosition);
 
-            const Player* player;
             Game* game;
-            Board::size_type position = 0;
+            PlayerSlot slot;
     };
 
+    /**
+      * The players of a game, stored by slot in contiguous arrays.
+      * Slots follow the order of the player ids, so a player id is found
+      * by binary search; names are only resolved through the Players registry.
+      */
     class GamePlayers {
         public:
-            GamePlayers (Game* game, const Players& players);
+            static constexpr PlayerSlot NO_SLOT = std::numeric_limits<PlayerSlot>::max();
 
-            inline Game* getGame() const {
-                return game;
+            GamePlayers (const Board& board, const Players& players);
+            GamePlayers (const Board& board, const Players& players, const PlayerId* ids, const PlayerSlot count);
+
+            inline PlayerSlot size() const {
+                return playerIds.size();
             }
 
-            GamePlayer* getPlayerByName(const std::string& name);
-            GamePlayer* findPlayerOnSpace(Board::size_type space, const GamePlayer* playerToExclude);
-        private:
-            Game* game;
+            inline PlayerId getPlayerId(const PlayerSlot slot) const {
+                return playerIds[slot];
+            }
+
+            inline const Player& getPlayer(const PlayerSlot slot) const {
+                return roster.get(playerIds[slot]);
+            }
+
+            inline Board::size_type getPosition(const PlayerSlot slot) const {
+                return positions[slot];
+            }
+
+            PlayerSlot findSlot(const PlayerId id) const;
+            PlayerSlot findSlot(std::string_view name) const;
+            PlayerSlot findPlayerOnSpace(const Board::size_type space, const PlayerSlot slotToExclude) const;
+
+            // moves the player keeping the occupancy index in sync
+            void place(const PlayerSlot slot, const Board::size_type space);
 
-            typedef std::unordered_map<std::string, GamePlayer> collection_type;
+            // seats every player of the roster at Start again, reusing the storage
+            void reset(const Board& board);
+            // seats the given players, sorted by id, at Start
+            void reset(const Board& board, const PlayerId* ids, const PlayerSlot count);
+
+            // seats the given players, sorted by id, on the given spaces
+            void restore(const Board& board, const PlayerId* ids, const std::uint32_t* spaces, const PlayerSlot count);
+        private:
+            // Start is shared by everybody, while a prank always swaps the two
+            // players involved: any other space holds at most one player
+            inline bool isIndexed(const Board::size_type space) const {
+                return (space > 0) && (space < occupants.size());
+            }
 
-            collection_type gamePlayers;
+            const Players& roster;
+            std::vector<PlayerId> playerIds;
+            std::vector<Board::size_type> positions;
+            std::vector<PlayerSlot> occupants;
     };
 
     class Game {
         public:
             explicit Game(const Players& players);
+            Game(const Players& players, std::shared_ptr<const Board> board);
+            // seats the given players only, sorted by id
+            Game(const Players& players, const PlayerId* ids, const PlayerSlot count);
 
             Game(Game&& other);
 
-            inline GamePlayer* findPlayerOnSpace(Board::size_type space, const GamePlayer* playerToExclude) {
-                return players.findPlayerOnSpace(space, playerToExclude);
+            // starts a new match in place, with the players currently in the roster
+            Game& reset();
+            // starts a new match in place, with the given players, sorted by id
+            Game& reset(const PlayerId* ids, const PlayerSlot count);
+
+            // puts back a match saved elsewhere (see Snapshot)
+            Game& restore(const PlayerId* ids, const std::uint32_t* spaces, const PlayerSlot count, const PlayerSlot winner);
+
+            inline PlayerSlot findPlayerOnSpace(Board::size_type space, const PlayerSlot slotToExclude) const {
+                return players.findPlayerOnSpace(space, slotToExclude);
             };
 
             std::string movePlayer(const std::string& name, Board::size_type firstDice, Board::size_type secondDice);
             std::string moveThrowingDice(const std::string& playerName);
 
-            inline Board& getBoard() {
-                return board;
+            // same as above, streaming the narration to a sink without allocating
+            void movePlayer(std::string_view name, Board::size_type firstDice, Board::size_type secondDice, mt::Sink& narration);
+            void moveThrowingDice(std::string_view playerName, mt::Sink& narration);
+
+            // same as above, addressing the player by slot
+            void movePlayer(const PlayerSlot slot, Board::size_type firstDice, Board::size_type secondDice, mt::Sink& narration);
+            void moveThrowingDice(const PlayerSlot slot, mt::Sink& narration);
+
+            // the move alone, for consumers that want no text
+            MoveResult move(const PlayerSlot slot, Board::size_type firstDice, Board::size_type secondDice);
+            MoveResult move(const PlayerSlot slot);
+            // a turn thrown for a bot, which may throw the dice again once
+            MoveResult move(const PlayerSlot slot, const Bot& bot);
+
+            // the dice of the game restart from a new stream, for reproducible games
+            inline Game& seed(const std::uint64_t seed) {
+                dice.seed(seed);
+                return *this;
             }
 
-            inline Game& setWinner(GamePlayer& player) {
-                winner = &player;
+            // tells the moves streamed to a sink, TextRenderer::INSTANCE by default
+            inline Game& setRenderer(const MoveRenderer& renderer) {
+                this->renderer = &renderer;
                 return *this;
             }
 
-            inline GamePlayer& getGamePlayer(const std::string& name) {
-                return *players.getPlayerByName(name);
+            inline const MoveRenderer& getRenderer() const {
+                return *renderer;
             }
 
-            inline const GamePlayer& getWinner() {
-                return *winner;
+            inline const Board& getBoard() const {
+                return *board;
             }
 
-            inline bool hasWinner() {
-                bool ret = winner != nullptr; 
-                return ret;
+            inline GamePlayers& getPlayers() {
+                return players;
+            }
+
+            inline const GamePlayers& getPlayers() const {
+                return players;
+            }
+
+            inline Game& setWinner(const PlayerSlot slot) {
+                winner = slot;
+                return *this;
+            }
+
+            inline GamePlayer getGamePlayer(const PlayerSlot slot) {
+                assert ( slot < players.size() );
+                return GamePlayer(this, slot);
+            }
+
+            inline GamePlayer getGamePlayer(const std::string& name) {
+                return getGamePlayer(players.findSlot(name));
+            }
+
+            inline GamePlayer getWinner() {
+                return getGamePlayer(winner);
+            }
+
+            inline bool hasWinner() const {
+                return winner != GamePlayers::NO_SLOT;
+            }
+
+            inline PlayerSlot getWinnerSlot() const {
+                return winner;
+            }
+
+            // ends the game in the current journal, if any, and starts it in the new one
+            void setJournal(Journal* journal);
+
+            inline std::uint32_t getJournalGame() const {
+                return journalGame;
             }
         private:
-            Board board;
+            std::shared_ptr<const Board> board;
             GamePlayers players;
-            GamePlayer* winner;
-            Dice dice1;
-            Dice dice2;
+            PlayerSlot winner = GamePlayers::NO_SLOT;
+            Dice dice;
+            const MoveRenderer* renderer = &TextRenderer::INSTANCE;
+            Journal* journal = nullptr;
+            std::uint32_t journalGame = 0;
+    };
+
+    inline Board::size_type GamePlayer::getPosition() const {
+        return game->getPlayers().getPosition(slot);
+    }
+
+    inline const Player* GamePlayer::getPlayer() const {
+        return &game->getPlayers().getPlayer(slot);
+    }
+
+
+    /**
+      * Recycles games: they are built once in chunked, contiguous storage and
+      * reset in place when acquired again. Not thread safe.
+      */
+    class GamePool : private mt::NonAssignable {
+      public:
+        // gives the game back to its pool
+        class Releaser {
+          public:
+            inline explicit Releaser(GamePool* pool = nullptr) : pool(pool) {};
+
+            inline void operator()(Game* game) const {
+                pool->release(game);
+            };
+          private:
+            GamePool* pool;
+        };
+
+        typedef std::unique_ptr<Game, Releaser> handle_type;
+
+        // games acquired from the pool are logged to the journal, when given
+        GamePool(const Players& players, std::size_t capacity, Journal* journal = nullptr);
+
+        handle_type acquire();
+        // a new game with the given players, sorted by id
+        handle_type acquire(const PlayerId* ids, const PlayerSlot count);
+        // a game in the state given, as Game::restore: it is logged to the journal only once restored
+        handle_type acquire(const PlayerId* ids, const std::uint32_t* spaces, const PlayerSlot count, const PlayerSlot winner);
+        void release(Game* game);
+
+        // the games acquired and not released yet
+        std::vector<const Game*> getActive() const;
+
+        inline std::size_t getCapacity() const {
+            return games.size();
+        };
+
+        inline std::size_t getAvailable() const {
+            return available.size();
+        };
+      private:
+        // an idle game as it was left, or a new one with nobody seated
+        Game* take();
+
+        const Players& players;
+        Journal* journal;
+        std::deque<Game> games;
+        std::vector<Game*> available;
     };
 
 
     class App {
       public:
-        inline App() {};
-        inline std::string addPlayer(const std::string& name) {
-            try {
-              players.addPlayer(Player(name));
-              return mt::string_format(Messages::PLAYER_ADDED, name.c_str());
-            } catch (std::exception& e) {
-              return mt::string_format(Messages::ADD_PLAYER_ERROR, name.c_str(), e.what());
-            }
+        // the app seats every player of its own registry
+        inline explicit App(Journal* journal = nullptr) :
+            players(std::make_shared<Players>()), pool(*players, 1, journal), shared(false) {};
+        // the app registers its players in a registry shared with other apps, safe from any
+        // thread, but seats and lists only the players it added: its roster and games are its own
+        inline explicit App(std::shared_ptr<Players> players, Journal* journal = nullptr) :
+            players(std::move(players)), pool(*this->players, 1, journal), shared(true) {};
+
+        // on a shared registry, a name taken by another app joins this roster
+        std::string addPlayer(const std::string& name);
+
+        // a new game with all the players of the roster, back to the pool when the handle is reset
+        inline GamePool::handle_type acquireGame() {
+            return shared ? pool.acquire(members.data(), members.size()) : pool.acquire();
         };
 
-        inline Game* createNewGame() {
-            return new Game(players);
-          };
+        // the names of the roster from the first on, at most count, comma separated
+        void writePlayers(mt::Sink& out, const PlayerId first, const PlayerId count) const;
+
+        inline void releaseGame(GamePool::handle_type game) {
+            game.reset();
+        };
         inline const Players& getPlayers() const {
-            return players;
+            return *players;
+        };
+        inline Players& getPlayers() {
+            return *players;
+        };
+        inline GamePool& getPool() {
+            return pool;
+        };
+        inline const GamePool& getPool() const {
+            return pool;
         };
       private:
-        Players players;
+        std::shared_ptr<Players> players;
+        GamePool pool;
+        bool shared;
+        // the ids added by this app to a shared registry, sorted
+        std::vector<PlayerId> members;
     }; // App
   } // namespace core
 } // namespace goose_game
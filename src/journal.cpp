@@ -0,0 +1,240 @@
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "journal.hpp"
+
+using namespace std;
+
+namespace goose_game {
+  namespace core {
+
+    namespace {
+        static_assert(std::is_trivially_copyable<JournalEntry>::value, "JournalEntry is written as raw bytes");
+        static_assert(sizeof(JournalEntry) == 24, "JournalEntry layout");
+
+        inline std::size_t padded(std::size_t size) {
+            return (size + sizeof(JournalEntry) - 1) / sizeof(JournalEntry) * sizeof(JournalEntry);
+        }
+
+        /**
+          * Calls visit(entry, extra) for every complete entry and returns the bytes they take:
+          * anything after them is the torn tail of an interrupted write.
+          */
+        template<class Visitor>
+        std::size_t scan(const char* data, const std::size_t size, Visitor&& visit) {
+            std::size_t offset = 0;
+            while (offset + sizeof(JournalEntry) <= size) {
+                JournalEntry entry;
+                std::memcpy(&entry, data + offset, sizeof(entry));
+                const std::size_t next = offset + sizeof(entry) + padded(entry.length);
+                if ( (entry.type < JournalEntry::GAME_STARTED) || (entry.type > JournalEntry::GAME_ENDED) || (next > size) ) {
+                    break;
+                }
+                visit(entry, data + offset + sizeof(entry));
+                offset = next;
+            }
+            return offset;
+        }
+
+        std::runtime_error systemError(const std::string& what) {
+            return std::runtime_error(what + ": " + strerror(errno));
+        }
+    }
+
+    /**
+      * Journal
+      */
+    Journal::Journal(const std::string& path) : fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644)), nextGame(1) {
+        if (!fd.isOpen()) {
+            throw systemError(path);
+        }
+        {
+            mt::MappedFile file(path);
+            std::uint32_t lastGame = 0;
+            fileSize = scan(file.data(), file.size(), [&lastGame](const JournalEntry& entry, const char*) {
+                lastGame = std::max(lastGame, entry.game);
+            });
+            nextGame = lastGame + 1;
+        }
+        if ( (::ftruncate(fd.get(), fileSize) < 0) || (::lseek(fd.get(), 0, SEEK_END) < 0) ) {
+            throw systemError(path);
+        }
+        writer = std::thread(&Journal::write, this);
+    }
+
+    Journal::~Journal() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeWriter.notify_one();
+        writer.join();
+    }
+
+    std::uint32_t Journal::startGame(const GamePlayers& players) {
+        const std::uint32_t game = nextGame++;
+        std::string names;
+        for (PlayerSlot slot = 0; slot < players.size(); ++slot) {
+            names += players.getPlayer(slot).getName();
+            names += '\0';
+        }
+        append(JournalEntry {JournalEntry::GAME_STARTED, 0, 0, 0, game, players.size(), 0, GamePlayers::NO_SLOT,
+                             static_cast<std::uint32_t>(names.size())}, names);
+        return game;
+    }
+
+    void Journal::movePlayer(const std::uint32_t game, const PlayerSlot slot, const Board::size_type firstDice,
+                             const Board::size_type secondDice, const Board::size_type position, const PlayerSlot pranked,
+                             const bool wins) {
+        append(JournalEntry {JournalEntry::PLAYER_MOVED, static_cast<std::uint8_t>(firstDice),
+                             static_cast<std::uint8_t>(secondDice), wins ? JournalEntry::WINS : std::uint8_t(0),
+                             game, slot, static_cast<std::uint32_t>(position), pranked, 0});
+    }
+
+    void Journal::endGame(const std::uint32_t game) {
+        append(JournalEntry {JournalEntry::GAME_ENDED, 0, 0, 0, game, 0, 0, GamePlayers::NO_SLOT, 0});
+    }
+
+    void Journal::sync() {
+        std::unique_lock<std::mutex> lock(mutex);
+        const std::uint64_t target = appended;
+        durable.wait(lock, [&]() { return (written >= target) || (error != 0); });
+        if (error != 0) {
+            throw std::runtime_error(std::string("Journal: ") + strerror(error));
+        }
+    }
+
+    void Journal::append(const JournalEntry& entry, const std::string& extra) {
+        bool wasIdle;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wasIdle = pending.empty();
+            const char* bytes = reinterpret_cast<const char*>(&entry);
+            pending.insert(pending.end(), bytes, bytes + sizeof(entry));
+            pending.insert(pending.end(), extra.begin(), extra.end());
+            pending.resize(pending.size() + padded(extra.size()) - extra.size(), 0);
+            appended += sizeof(entry) + padded(extra.size());
+        }
+        if (wasIdle) {
+            wakeWriter.notify_one();
+        }
+    }
+
+    void Journal::write() {
+        std::vector<char> batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeWriter.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            // the callers go on filling the other buffer while this one is written
+            batch.swap(pending);
+            const std::uint64_t target = appended;
+            lock.unlock();
+
+            // a failed batch is cut off, so the next one follows the last complete entry;
+            // when even that fails, nothing more is written after the torn tail
+            int failure = torn ? EIO : 0;
+            std::size_t done = 0;
+            while ( (done < batch.size()) && (failure == 0) ) {
+                ssize_t count = ::write(fd.get(), batch.data() + done, batch.size() - done);
+                if (count >= 0) {
+                    done += count;
+                } else if (errno != EINTR) {
+                    failure = errno;
+                }
+            }
+            if ( (failure == 0) && (::fdatasync(fd.get()) < 0) ) {
+                failure = errno;
+            }
+            if (failure == 0) {
+                fileSize += batch.size();
+            } else if (!torn) {
+                torn = (::ftruncate(fd.get(), fileSize) < 0) || (::lseek(fd.get(), fileSize, SEEK_SET) < 0);
+            }
+            batch.clear();
+
+            lock.lock();
+            if (failure != 0) {
+                error = failure;
+            } else {
+                written = target;
+                ++commits;
+            }
+            durable.notify_all();
+        }
+    }
+
+    /**
+      * JournalReplay
+      */
+    JournalReplay::JournalReplay(const std::string& path) {
+        mt::MappedFile file(path);
+        RestoredGame* last = nullptr;
+        std::uint32_t lastId = 0;
+
+        validSize = scan(file.data(), file.size(), [&](const JournalEntry& entry, const char* extra) {
+            ++entryCount;
+            lastGame = std::max(lastGame, entry.game);
+
+            if (entry.type == JournalEntry::GAME_STARTED) {
+                // every name takes a byte at least: a corrupt player count cannot read past the names
+                RestoredGame restored;
+                restored.names.reserve(std::min(entry.slot, entry.length));
+                const char* name = extra;
+                const char* end = extra + entry.length;
+                for (std::uint32_t slot = 0; (slot < entry.slot) && (name < end); ++slot) {
+                    const std::size_t size = strnlen(name, end - name);
+                    restored.names.emplace_back(name, size);
+                    name += size + 1;
+                }
+                restored.positions.assign(restored.names.size(), 0);
+                last = &(games[entry.game] = std::move(restored));
+                lastId = entry.game;
+                return;
+            }
+
+            // moves of one game usually come in a row: skip the lookup
+            RestoredGame* restored = last;
+            if ( (restored == nullptr) || (lastId != entry.game) ) {
+                auto iter = games.find(entry.game);
+                restored = (iter != games.end()) ? &iter->second : nullptr;
+            }
+            if (restored == nullptr) {
+                return;
+            }
+            if (entry.type == JournalEntry::GAME_ENDED) {
+                games.erase(entry.game);
+                last = nullptr;
+                return;
+            }
+            last = restored;
+            lastId = entry.game;
+
+            std::vector<std::uint32_t>& positions = restored->positions;
+            if (entry.slot >= positions.size()) {
+                return;
+            }
+            if (entry.pranked < positions.size()) {
+                positions[entry.pranked] = positions[entry.slot];
+            }
+            positions[entry.slot] = entry.position;
+            if (entry.flags & JournalEntry::WINS) {
+                restored->winner = entry.slot;
+            }
+        });
+    }
+
+    const JournalReplay::RestoredGame* JournalReplay::find(const std::uint32_t game) const {
+        auto iter = games.find(game);
+        return (iter != games.end()) ? &iter->second : nullptr;
+    }
+  }
+}
@@ -0,0 +1,142 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Fixed-size journal entry. A GAME_STARTED entry is followed by the names of
+      * the players in slot order, each ending with a NUL, padded to sizeof(JournalEntry).
+      * Entries are written in native byte order.
+      */
+    struct JournalEntry {
+        enum Type : std::uint8_t {
+            GAME_STARTED = 1,
+            PLAYER_MOVED,
+            GAME_ENDED
+        };
+
+        static constexpr std::uint8_t WINS = 1;
+
+        std::uint8_t type;
+        std::uint8_t firstDice;
+        std::uint8_t secondDice;
+        std::uint8_t flags;
+        std::uint32_t game;
+        std::uint32_t slot;        // the player count for GAME_STARTED
+        std::uint32_t position;    // of the player after the move
+        std::uint32_t pranked;     // slot sent back by the move, or GamePlayers::NO_SLOT
+        std::uint32_t length;      // bytes following the entry
+    };
+
+    /**
+      * Append-only log of the games. Entries are buffered by the callers and
+      * written by a single thread: every write carries whatever was appended
+      * during the previous one and ends with one fdatasync (group commit).
+      */
+    class Journal : private mt::NonAssignable {
+        public:
+            // appends to path, cutting a torn entry left at its end by a crash
+            explicit Journal(const std::string& path);
+            ~Journal();
+
+            // returns the id of the new game
+            std::uint32_t startGame(const GamePlayers& players);
+            void movePlayer(const std::uint32_t game, const PlayerSlot slot, const Board::size_type firstDice,
+                            const Board::size_type secondDice, const Board::size_type position, const PlayerSlot pranked,
+                            const bool wins);
+            void endGame(const std::uint32_t game);
+
+            // blocks until every entry appended so far is on disk
+            void sync();
+
+            inline std::uint64_t getCommits() const {
+                return commits;
+            }
+        private:
+            void append(const JournalEntry& entry, const std::string& extra = std::string());
+            void write();
+
+            mt::FileDescriptor fd;
+            // of the entries committed, and whether a failed batch could not be cut off: writer only
+            std::uint64_t fileSize = 0;
+            bool torn = false;
+            std::atomic<std::uint32_t> nextGame;
+            std::mutex mutex;
+            std::condition_variable wakeWriter;
+            std::condition_variable durable;
+            std::vector<char> pending;
+            std::uint64_t appended = 0;    // bytes
+            std::uint64_t written = 0;
+            std::atomic<std::uint64_t> commits {0};
+            int error = 0;
+            bool stopping = false;
+            std::thread writer;
+    };
+
+    /**
+      * Games rebuilt from a journal read through a memory mapping.
+      * Games that ended are dropped, the others get back their players,
+      * positions and winner. A game keeps only the names of its own players,
+      * by slot, not a registry: to play it on, add the names to the Players
+      * of an App and Game::restore it there.
+      */
+    class JournalReplay : private mt::NonAssignable {
+        public:
+            struct RestoredGame {
+                std::vector<std::string> names;         // by slot
+                std::vector<std::uint32_t> positions;   // by slot
+                PlayerSlot winner = GamePlayers::NO_SLOT;
+
+                inline PlayerSlot size() const {
+                    return names.size();
+                }
+
+                inline bool hasWinner() const {
+                    return winner != GamePlayers::NO_SLOT;
+                }
+            };
+
+            explicit JournalReplay(const std::string& path);
+
+            // nullptr if the game ended or never existed
+            const RestoredGame* find(const std::uint32_t game) const;
+
+            inline const std::unordered_map<std::uint32_t, RestoredGame>& getGames() const {
+                return games;
+            }
+
+            inline std::uint64_t getEntryCount() const {
+                return entryCount;
+            }
+
+            // bytes of the complete entries: the rest of the file is a torn write
+            inline std::uint64_t getValidSize() const {
+                return validSize;
+            }
+
+            inline std::uint32_t getLastGame() const {
+                return lastGame;
+            }
+        private:
+            std::unordered_map<std::uint32_t, RestoredGame> games;
+            std::uint64_t entryCount = 0;
+            std::uint64_t validSize = 0;
+            std::uint32_t lastGame = 0;
+    };
+  }
+}
+
+#endif //JOURNAL_H
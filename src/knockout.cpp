@@ -0,0 +1,49 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "core.hpp"
+#include "tournament.hpp"
+#include "work_pool.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+/*
+ * usage: goose_tournament [players] [table-size] [threads] [seed]
+ */
+int main(int argc, char* argv[]) {
+  const unsigned long playerCount = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 50000;
+  const unsigned int tableSize = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 6;
+  const unsigned int threadCount = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 0;
+  const std::uint64_t seed = (argc > 4) ? strtoull(argv[4], nullptr, 10) : mt::randomSeed();
+
+  if ( (playerCount == 0) || (tableSize < 2) ) {
+    cerr << "usage: goose_tournament [players] [table-size] [threads] [seed]" << endl;
+    return 1;
+  }
+
+  App app;
+  app.getPlayers().reserve(playerCount);
+  for (unsigned long i = 0; i < playerCount; ++i) {
+    app.getPlayers().addPlayer(Player("player" + to_string(i)));
+  }
+
+  mt::WorkStealingPool pool(threadCount);
+  Tournament tournament(app.getPlayers(), Board::classic(), tableSize, seed);
+
+  auto start = chrono::steady_clock::now();
+  PlayerId champion = tournament.run(pool);
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  cout << "players: " << playerCount << ", table size: " << tableSize
+       << ", seed: " << seed << ", threads: " << pool.getThreadCount() << "\n";
+  unsigned int round = 0;
+  for (const TournamentRound& summary : tournament.getRounds()) {
+    cout << "round " << ++round << ": " << summary.players << " players at " << summary.tables << " tables, "
+         << summary.turns << " turns, " << (summary.seconds * 1000) << " ms\n";
+  }
+  cout << "champion: " << app.getPlayers().get(champion).getName() << "\n"
+       << "elapsed: " << elapsed.count() << " s, steals: " << pool.getSteals() << "\n";
+}
@@ -0,0 +1,249 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "layout.hpp"
+
+using namespace std;
+
+namespace goose_game {
+  namespace core {
+
+    namespace {
+        const char MAGIC[8] = {'G', 'O', 'O', 'S', 'E', 'B', 'R', 'D'};
+        const std::uint32_t VERSION = 1;
+        const std::size_t MOVES_PER_SPACE = Board::MAX_DICE - Board::MIN_DICE + 1;
+
+        struct Header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t spaceCount;
+            std::uint32_t moveSize;
+            std::uint32_t reserved;
+        };
+
+        static_assert(std::is_trivially_copyable<Board::Move>::value, "Board::Move is written as raw bytes");
+        static_assert(sizeof(Header) == 24, "Header layout");
+
+        inline std::size_t padded(std::size_t size) {
+            return (size + 3) & ~std::size_t(3);
+        }
+
+        inline std::size_t binarySize(std::size_t spaceCount) {
+            return sizeof(Header) + padded(spaceCount) + spaceCount * sizeof(std::uint32_t)
+                    + spaceCount * MOVES_PER_SPACE * sizeof(Board::Move);
+        }
+
+        invalid_argument error(const std::string& path, const std::string& reason) {
+            return invalid_argument(path + ": " + reason);
+        }
+    }
+
+    /**
+     * BoardFile class
+     */
+    std::shared_ptr<const Board> BoardFile::loadText(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            throw error(path, "cannot open");
+        }
+
+        std::vector<std::uint8_t> spaces;
+        std::vector<std::uint32_t> jumps;
+        std::string line;
+        unsigned int lineNumber = 0;
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            auto comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            std::istringstream words(line);
+            std::string directive;
+            if (!(words >> directive)) {
+                continue;
+            }
+
+            auto lineError = [&](const std::string& reason) {
+                return error(path, "line " + std::to_string(lineNumber) + ": " + reason);
+            };
+            auto checkSpace = [&](std::uint64_t space) {
+                if ( (space == 0) || (space + 1 >= spaces.size()) ) {
+                    throw lineError("no space " + std::to_string(space) + " for " + directive);
+                }
+            };
+
+            std::uint64_t value;
+            if (directive == "spaces") {
+                if (!spaces.empty()) {
+                    throw lineError("spaces given twice");
+                }
+                if ( !(words >> value) || (value <= Board::MAX_DICE) || (value > UINT32_MAX) ) {
+                    throw lineError("spaces needs a count above " + std::to_string(Board::MAX_DICE));
+                }
+                spaces.assign(value, NORMAL);
+                spaces.back() = FINISH;
+                jumps.assign(value, 0);
+            } else if (spaces.empty()) {
+                throw lineError("spaces must come first");
+            } else if ( (directive == "goose") || (directive == "death") ) {
+                while (words >> value) {
+                    checkSpace(value);
+                    spaces[value] = (directive == "goose") ? GOOSE : DEATH;
+                }
+            } else if (directive == "bridge") {
+                std::uint64_t target;
+                if ( !(words >> value >> target) ) {
+                    throw lineError("bridge needs a space and a target");
+                }
+                checkSpace(value);
+                if (target >= spaces.size()) {
+                    throw lineError("no target " + std::to_string(target) + " for bridge");
+                }
+                if (target == 0) {
+                    throw lineError("a bridge cannot lead to Start, use death");
+                }
+                spaces[value] = BRIDGE;
+                jumps[value] = target;
+            } else {
+                throw lineError("unknown directive " + directive);
+            }
+            words.clear();
+            std::string rest;
+            if (words >> rest) {
+                throw lineError("unexpected " + rest + " after " + directive);
+            }
+        }
+        if (spaces.empty()) {
+            throw error(path, "no spaces");
+        }
+
+        try {
+            return std::make_shared<const Board>(std::move(spaces), std::move(jumps));
+        } catch (invalid_argument& e) {
+            throw error(path, e.what());
+        }
+    }
+
+    std::shared_ptr<const Board> BoardFile::loadBinary(const std::string& path) {
+        mt::MappedFile file(path);
+
+        Header header;
+        if (file.size() < sizeof(header)) {
+            throw error(path, "truncated header");
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw error(path, "not a binary board");
+        }
+        if ( (header.version != VERSION) || (header.moveSize != sizeof(Board::Move)) ) {
+            throw error(path, "binary board of another version or platform");
+        }
+        if (file.size() != binarySize(header.spaceCount)) {
+            throw error(path, "size does not match the header");
+        }
+
+        std::size_t count = header.spaceCount;
+        const char* data = file.data() + sizeof(header);
+        std::vector<std::uint8_t> spaces(count);
+        std::memcpy(spaces.data(), data, count);
+        data += padded(count);
+
+        std::vector<std::uint32_t> jumps(count);
+        std::memcpy(jumps.data(), data, count * sizeof(std::uint32_t));
+        data += count * sizeof(std::uint32_t);
+
+        std::vector<Board::Move> moves(count * MOVES_PER_SPACE);
+        std::memcpy(moves.data(), data, moves.size() * sizeof(Board::Move));
+
+        try {
+            return std::make_shared<const Board>(std::move(spaces), std::move(jumps), std::move(moves));
+        } catch (invalid_argument& e) {
+            throw error(path, e.what());
+        }
+    }
+
+    std::shared_ptr<const Board> BoardFile::load(const std::string& path) {
+        char magic[sizeof(MAGIC)] = {};
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw error(path, "cannot open");
+        }
+        in.read(magic, sizeof(magic));
+        if ( (in.gcount() == sizeof(magic)) && (std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0) ) {
+            return loadBinary(path);
+        }
+        return loadText(path);
+    }
+
+    void BoardFile::saveBinary(const Board& board, const std::string& path) {
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.spaceCount = board.getSpaces().size();
+        header.moveSize = sizeof(Board::Move);
+        header.reserved = 0;
+
+        std::string bytes(binarySize(header.spaceCount), '\0');
+        char* data = bytes.data();
+        std::memcpy(data, &header, sizeof(header));
+        data += sizeof(header);
+        std::memcpy(data, board.getSpaces().data(), header.spaceCount);
+        data += padded(header.spaceCount);
+        std::memcpy(data, board.getJumps().data(), header.spaceCount * sizeof(std::uint32_t));
+        data += header.spaceCount * sizeof(std::uint32_t);
+        std::memcpy(data, board.getMoves().data(), board.getMoves().size() * sizeof(Board::Move));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+        if (!out) {
+            throw error(path, "cannot write");
+        }
+    }
+
+    void BoardFile::saveText(const Board& board, std::ostream& out) {
+        out << "spaces " << board.getSpaces().size() << "\n";
+        for (SpaceType type : {GOOSE, DEATH}) {
+            std::string indexes;
+            for (Board::size_type index = 1; index < board.getLastIndex(); ++index) {
+                if (board.get(index) == type) {
+                    indexes += " " + std::to_string(index);
+                }
+            }
+            if (!indexes.empty()) {
+                out << ((type == GOOSE) ? "goose" : "death") << indexes << "\n";
+            }
+        }
+        for (Board::size_type index = 1; index < board.getLastIndex(); ++index) {
+            if (board.get(index) == BRIDGE) {
+                out << "bridge " << index << " " << board.getJump(index) << "\n";
+            }
+        }
+    }
+
+    /**
+     * BoardCatalog class
+     */
+    BoardCatalog::BoardCatalog(const std::string& directory) {
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            std::error_code error;
+            if (!entry.is_regular_file(error)) {
+                continue;
+            }
+            try {
+                boards.emplace(entry.path().stem().string(), BoardFile::load(entry.path().string()));
+            } catch (const std::exception& e) {
+                errors.emplace(entry.path().string(), e.what());
+            }
+        }
+    }
+
+    std::shared_ptr<const Board> BoardCatalog::find(const std::string& name) const {
+        auto iter = boards.find(name);
+        return (iter != boards.end()) ? iter->second : nullptr;
+    }
+  }
+}
@@ -0,0 +1,65 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "core.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Reads and writes Board layouts.
+      *
+      * The text format has one directive per line, '#' starts a comment:
+      *   spaces 64
+      *   goose 5 9 14
+      *   bridge 6 12
+      *   death 58
+      *
+      * The binary format is a fixed header followed by the space types,
+      * the jump targets and the compiled move table, in native byte order,
+      * so that loading it needs no rule walking at all.
+      */
+    class BoardFile final {
+        public:
+            static std::shared_ptr<const Board> loadText(const std::string& path);
+            static std::shared_ptr<const Board> loadBinary(const std::string& path);
+
+            // binary or text, by the magic at the beginning of the file
+            static std::shared_ptr<const Board> load(const std::string& path);
+
+            static void saveBinary(const Board& board, const std::string& path);
+            static void saveText(const Board& board, std::ostream& out);
+    };
+
+    /**
+      * Every layout of a directory, by file name without extension.
+      * A file that cannot be read or is not a valid layout is left out,
+      * and the reason is kept by path in getErrors().
+      */
+    class BoardCatalog {
+        public:
+            explicit BoardCatalog(const std::string& directory);
+
+            // nullptr when there is no such layout
+            std::shared_ptr<const Board> find(const std::string& name) const;
+
+            inline const std::map<std::string, std::shared_ptr<const Board>>& getAll() const {
+                return boards;
+            }
+
+            inline const std::map<std::string, std::string>& getErrors() const {
+                return errors;
+            }
+        private:
+            std::map<std::string, std::shared_ptr<const Board>> boards;
+            std::map<std::string, std::string> errors;
+    };
+  }
+}
+
+#endif
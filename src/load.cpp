@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "mt.hpp"
+#include "rng.hpp"
+
+using namespace std;
+
+namespace {
+  int connectTo(const string& address) {
+    int fd;
+    if (address.find_first_not_of("0123456789") == string::npos) {
+      fd = socket(AF_INET, SOCK_STREAM, 0);
+      sockaddr_in remote {};
+      remote.sin_family = AF_INET;
+      remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      remote.sin_port = htons(stoi(address));
+      if ( (fd < 0) || (connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) < 0) ) {
+        return -1;
+      }
+    } else {
+      fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      sockaddr_un remote {};
+      remote.sun_family = AF_UNIX;
+      strncpy(remote.sun_path, address.c_str(), sizeof(remote.sun_path) - 1);
+      if ( (fd < 0) || (connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) < 0) ) {
+        return -1;
+      }
+    }
+    return fd;
+  }
+
+  // two players, one game played with explicit dice, then exit
+  string makeScript(mt::Xoshiro256& random, unsigned int moves) {
+    string script = "add player Pippo\nadd player Pluto\nplay\n";
+    for (unsigned int i = 0; i < moves; ++i) {
+      script.append(mt::string_format("move %s %d, %d\n", (i % 2) ? "Pluto" : "Pippo",
+                                      int(random() % 6) + 1, int(random() % 6) + 1));
+    }
+    script.append("exit\nexit\n");
+    return script;
+  }
+}
+
+/*
+ * Opens all the sessions at once, sends every script, then reads the replies.
+ * usage: goose_load <port|unix-socket-path> [connections] [moves] [seed]
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cerr << "usage: goose_load <port|unix-socket-path> [connections] [moves] [seed]" << endl;
+    return 1;
+  }
+  const unsigned int connections = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000;
+  const unsigned int moves = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 100;
+  mt::Xoshiro256 random((argc > 4) ? strtoull(argv[4], nullptr, 10) : 1);
+
+  auto start = chrono::steady_clock::now();
+  vector<int> fds;
+  std::uint64_t commands {0}, received {0};
+  for (unsigned int i = 0; i < connections; ++i) {
+    int fd = connectTo(argv[1]);
+    if (fd < 0) {
+      cerr << "connection " << i << ": " << strerror(errno) << endl;
+      return 1;
+    }
+    string script = makeScript(random, moves);
+    if (write(fd, script.data(), script.size()) != ssize_t(script.size())) {
+      cerr << "connection " << i << ": short write" << endl;
+      return 1;
+    }
+    commands += moves + 5;
+    fds.push_back(fd);
+  }
+
+  char buffer[64 * 1024];
+  for (int fd : fds) {
+    ssize_t size;
+    while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+      received += size;
+    }
+    close(fd);
+  }
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  cout << "sessions: " << connections << ", commands: " << commands << ", bytes received: " << received << "\n"
+       << "elapsed: " << elapsed.count() << " s, " << (commands / elapsed.count()) << " commands/sec" << endl;
+}
@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "bot.hpp"
+#include "core.hpp"
+#include "rng.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+namespace {
+  // plays the games; the player in slot game % players is the bot, or all of them with allBots
+  std::uint64_t play(Game& game, const Bot& bot, const std::uint64_t games, const std::uint64_t seed,
+                     const bool allBots, std::uint64_t& botWins) {
+    const PlayerSlot playerCount = game.getPlayers().size();
+    std::uint64_t turns = 0;
+    for (std::uint64_t i = 0; i < games; ++i) {
+      game.reset().seed(mt::Xoshiro256::streamSeed(seed, i));
+      const PlayerSlot botSlot = i % playerCount;
+      for (PlayerSlot slot = 0; !game.hasWinner(); slot = (slot + 1) % playerCount) {
+        if (allBots || (slot == botSlot)) {
+          game.move(slot, bot);
+        } else {
+          game.move(slot);
+        }
+        ++turns;
+      }
+      botWins += (game.getWinnerSlot() == botSlot);
+    }
+    return turns;
+  }
+}
+
+/*
+ * usage: goose_bots [games] [players] [seed]
+ */
+int main(int argc, char* argv[]) {
+  const std::uint64_t games = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 100000;
+  const unsigned int playerCount = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 4;
+  const std::uint64_t seed = (argc > 3) ? strtoull(argv[3], nullptr, 10) : mt::randomSeed();
+
+  if ( (games == 0) || (playerCount < 2) ) {
+    cerr << "usage: goose_bots [games] [players] [seed], with 2 players at least" << endl;
+    return 1;
+  }
+
+  App app;
+  for (unsigned int i = 0; i < playerCount; ++i) {
+    app.getPlayers().addPlayer(Player("bot" + to_string(i)));
+  }
+  Game game(app.getPlayers());
+  ExpectationBot bot(Board::classic());
+
+  std::uint64_t botWins = 0;
+  auto start = chrono::steady_clock::now();
+  std::uint64_t turns = play(game, bot, games, seed, true, botWins);
+  chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+  cout << "games: " << games << ", players: " << playerCount << ", seed: " << seed << "\n"
+       << "all bots: " << (double(turns) / games) << " turns/game, "
+       << (turns / elapsed.count()) << " bot turns/ms\n";
+
+  botWins = 0;
+  turns = play(game, bot, games, seed, false, botWins);
+  cout << "one bot among plain players: " << (double(turns) / games) << " turns/game, the bot wins "
+       << (100.0 * botWins / games) << "% (fair share " << (100.0 / playerCount) << "%)\n";
+}
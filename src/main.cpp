@@ -20,7 +20,22 @@ packet[14]='c';
 
 using namespace goose_game::view;
 
-int main() {
+int main(int argc, char* argv[]) {
+  // goose_game --batch|--json [script]: replies only, for scripted and piped input,
+  // with the moves as narration or as JSON
+  if ( (argc > 1) && ((string(argv[1]) == "--batch") || (string(argv[1]) == "--json")) ) {
+    const goose_game::core::MoveRenderer& renderer = (string(argv[1]) == "--json") ?
+        static_cast<const goose_game::core::MoveRenderer&>(JsonRenderer::INSTANCE) : goose_game::core::TextRenderer::INSTANCE;
+    try {
+      BatchView bv(argc > 2 ? argv[2] : "", renderer);
+      bv.show();
+    } catch (const exception& e) {
+      cerr << e.what() << endl;
+      return 1;
+    }
+    return 0;
+  }
+
   cout << "hello!" << endl;
 
   AppView av;
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "markov.hpp"
+
+using namespace std;
+
+namespace goose_game {
+  namespace core {
+
+    namespace {
+        // probability of each sum of two dice, from Board::MIN_DICE
+        const double DICE_PROBABILITIES[] = {
+            1 / 36.0, 2 / 36.0, 3 / 36.0, 4 / 36.0, 5 / 36.0, 6 / 36.0, 5 / 36.0, 4 / 36.0, 3 / 36.0, 2 / 36.0, 1 / 36.0 };
+    }
+
+    /**
+      * MarkovSolver
+      */
+    MarkovSolver::MarkovSolver(std::shared_ptr<const Board> board) : board(std::move(board)) {
+        const Board& layout = *this->board;
+        const Board::size_type last = layout.getLastIndex();
+        lowestBackwardTarget = last;
+        for (Board::size_type from = 0; from < last; ++from) {
+            for (Board::size_type dice = Board::MIN_DICE; dice <= Board::MAX_DICE; ++dice) {
+                const Board::size_type target = layout.getMove(from, dice).target;
+                const Board::size_type plainTarget = from + dice;
+                if (target != plainTarget) {
+                    corrections.push_back(Correction {from, plainTarget, target,
+                                                      DICE_PROBABILITIES[dice - Board::MIN_DICE]});
+                }
+                if (target <= from) {
+                    lowestBackwardTarget = std::min(lowestBackwardTarget, target);
+                }
+            }
+        }
+
+        // a space that cannot reach the finish traps every space that can reach it
+        std::vector<std::vector<Board::size_type>> sources(last + 1);
+        for (Board::size_type from = 0; from < last; ++from) {
+            for (Board::size_type dice = Board::MIN_DICE; dice <= Board::MAX_DICE; ++dice) {
+                sources[layout.getMove(from, dice).target].push_back(from);
+            }
+        }
+        auto spread = [&](std::vector<bool>& marked, std::vector<Board::size_type> pending) {
+            while (!pending.empty()) {
+                const Board::size_type space = pending.back();
+                pending.pop_back();
+                for (Board::size_type from : sources[space]) {
+                    if (!marked[from]) {
+                        marked[from] = true;
+                        pending.push_back(from);
+                    }
+                }
+            }
+        };
+        std::vector<bool> finishing(last + 1, false);
+        finishing[last] = true;
+        spread(finishing, {last});
+        unfinishable.assign(last + 1, false);
+        std::vector<Board::size_type> traps;
+        for (Board::size_type space = 0; space < last; ++space) {
+            if (!finishing[space]) {
+                unfinishable[space] = true;
+                traps.push_back(space);
+            }
+        }
+        spread(unfinishable, std::move(traps));
+        if (unfinishable[0]) {
+            throw invalid_argument("Start may never reach the finish in MarkovSolver constructor");
+        }
+    }
+
+    MarkovSolver::Window MarkovSolver::step(const std::vector<double>& current, const Window window,
+                                            std::vector<double>& next) const {
+        const Board::size_type last = current.size() - 1;
+        Window reached {std::min(window.first + Board::MIN_DICE, last), std::min(window.last + Board::MAX_DICE, last)};
+
+        // plain moves: next[s] += p(d) * current[s - d], one contiguous pass per dice sum
+        for (Board::size_type dice = Board::MIN_DICE; dice <= Board::MAX_DICE; ++dice) {
+            if (window.first + dice > last) {
+                break;
+            }
+            const double probability = DICE_PROBABILITIES[dice - Board::MIN_DICE];
+            const double* __restrict source = current.data() + window.first;
+            double* __restrict target = next.data() + window.first + dice;
+            const Board::size_type count = std::min(window.last + dice, last) - (window.first + dice) + 1;
+            for (Board::size_type i = 0; i < count; ++i) {
+                target[i] += probability * source[i];
+            }
+        }
+
+        for (const Correction& correction : corrections) {
+            if ( (correction.from < window.first) || (correction.from > window.last) ) {
+                continue;
+            }
+            const double mass = current[correction.from] * correction.probability;
+            if (correction.plainTarget <= last) {
+                next[correction.plainTarget] -= mass;
+            }
+            next[correction.target] += mass;
+            reached.first = std::min(reached.first, correction.target);
+            reached.last = std::max(reached.last, correction.target);
+        }
+        return reached;
+    }
+
+    std::vector<double> MarkovSolver::solveExpectedTurns(const double epsilon) const {
+        // E[s] = 1 + sum p(d) E[target(s, d)]. Below lowestBackwardTarget every move goes
+        // forward, so only the spaces above need Gauss-Seidel sweeps, the others one pass
+        const Board& layout = *board;
+        const Board::size_type last = layout.getLastIndex();
+        std::vector<double> expected(last + 1, 0.0);
+        for (Board::size_type space = 0; space < last; ++space) {
+            if (unfinishable[space]) {
+                expected[space] = INFINITY;
+            }
+        }
+
+        auto update = [&](const Board::size_type from) {
+            if (unfinishable[from]) {
+                return 0.0;
+            }
+            double value = 1.0;
+            for (Board::size_type dice = Board::MIN_DICE; dice <= Board::MAX_DICE; ++dice) {
+                value += DICE_PROBABILITIES[dice - Board::MIN_DICE] * expected[layout.getMove(from, dice).target];
+            }
+            double change = std::abs(value - expected[from]) / value;
+            expected[from] = value;
+            return change;
+        };
+
+        double change;
+        do {
+            change = 0.0;
+            for (Board::size_type from = last; from-- > lowestBackwardTarget; ) {
+                change = std::max(change, update(from));
+            }
+        } while (change > epsilon);
+        for (Board::size_type from = lowestBackwardTarget; from-- > 0; ) {
+            update(from);
+        }
+        return expected;
+    }
+
+    MarkovAnalysis MarkovSolver::solve(const double epsilon, const std::size_t maxTurns) const {
+        const Board::size_type last = board->getLastIndex();
+        // probability below this at the edges of the window is dropped, and stays in remaining
+        const double negligible = epsilon / (1000.0 * (last + 1));
+        MarkovAnalysis analysis;
+        analysis.visits.assign(last + 1, 0.0);
+        analysis.finishByTurn.push_back(0.0);
+
+        std::vector<double> current(last + 1, 0.0), next(last + 1, 0.0);
+        Window window {0, 0};
+        current[0] = 1.0;
+        double remaining = 1.0;
+        for (std::size_t turn = 1; (turn <= maxTurns) && (remaining > epsilon); ++turn) {
+            Window reached = step(current, window, next);
+            std::fill(current.begin() + window.first, current.begin() + window.last + 1, 0.0);
+
+            const double finished = next[last];
+            next[last] = 0.0;
+            analysis.finishByTurn.push_back(finished);
+            remaining -= finished;
+
+            while ( (reached.first < reached.last) && (next[reached.first] < negligible) ) {
+                next[reached.first++] = 0.0;
+            }
+            while ( (reached.last > reached.first) && (next[reached.last] < negligible) ) {
+                next[reached.last--] = 0.0;
+            }
+            for (Board::size_type space = reached.first; space <= reached.last; ++space) {
+                analysis.visits[space] += next[space];
+            }
+            current.swap(next);
+            window = reached;
+        }
+        analysis.visits[last] = 1.0 - remaining;
+        analysis.unresolved = std::max(0.0, remaining);
+
+        analysis.expectedTurnsFrom = solveExpectedTurns(epsilon);
+        analysis.expectedTurns = analysis.expectedTurnsFrom[0];
+        return analysis;
+    }
+  } // core
+} // goose_game
@@ -0,0 +1,63 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+#include <vector>
+
+#include "core.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Exact figures of a single player walking the board, where every turn
+      * is a step of a Markov chain over the spaces (pranks need two players
+      * and are not part of it)
+      */
+    struct MarkovAnalysis {
+        std::vector<double> finishByTurn;       // [t]: probability to finish on turn t
+        std::vector<double> expectedTurnsFrom;  // [s]: expected turns to finish from space s, infinite if it may never
+        std::vector<double> visits;             // [s]: expected turns ending on space s, from Start
+        double expectedTurns;                   // from Start
+        double unresolved;                      // probability mass left when the distribution was cut
+    };
+
+    /**
+      * Builds the chain from the move table of a Board.
+      * Most of a turn is the same dice convolution everywhere, so the kernel
+      * applies it on contiguous arrays and then fixes up the few (space, dice)
+      * pairs where a goose, a bridge, a bounce or the finish changes the target.
+      * Only the window of spaces still holding probability is processed.
+      */
+    class MarkovSolver {
+        public:
+            // throws invalid_argument when a walk from Start may never finish
+            explicit MarkovSolver(std::shared_ptr<const Board> board);
+
+            // stops the first passage distribution when less than epsilon is left
+            MarkovAnalysis solve(const double epsilon = 1e-12, const std::size_t maxTurns = 1000000) const;
+        private:
+            struct Correction {
+                Board::size_type from;
+                Board::size_type plainTarget;   // where the convolution put the mass
+                Board::size_type target;
+                double probability;
+            };
+
+            // spaces [first, last] that may hold probability
+            struct Window {
+                Board::size_type first;
+                Board::size_type last;
+            };
+
+            Window step(const std::vector<double>& current, const Window window, std::vector<double>& next) const;
+            std::vector<double> solveExpectedTurns(const double epsilon) const;
+
+            std::shared_ptr<const Board> board;
+            std::vector<Correction> corrections;
+            Board::size_type lowestBackwardTarget;  // no move from below here goes backwards
+            std::vector<bool> unfinishable;         // [s]: a walk from s may never finish
+    };
+  } // namespace core
+} // namespace goose_game
+
+#endif //MARKOV_H
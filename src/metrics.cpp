@@ -0,0 +1,120 @@
+#include "metrics.hpp"
+
+#include <deque>
+#include <mutex>
+
+namespace goose_game {
+  namespace metrics {
+
+    namespace {
+        const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+            "commands", "moves", "pranks", "goose_hops", "bridges", "bounces", "deaths", "wins"
+        };
+
+        const char* const TIMER_NAMES[TIMER_COUNT] = {
+            "command", "command_parse", "move_resolve", "narration_render"
+        };
+
+        // the blocks never move nor go away, threads keep a reference to theirs
+        std::mutex registryMutex;
+        std::deque<ThreadMetrics> registry;
+
+        const std::string PROMETHEUS_COUNTER = "# TYPE goose_%s_total counter\ngoose_%s_total %llu\n";
+        const std::string PROMETHEUS_HISTOGRAM = "# TYPE goose_%s_seconds histogram\n";
+        const std::string PROMETHEUS_BUCKET = "goose_%s_seconds_bucket{le=\"%.9g\"} %llu\n";
+        const std::string PROMETHEUS_TOTALS = "goose_%s_seconds_bucket{le=\"+Inf\"} %llu\n"
+                                              "goose_%s_seconds_sum %.9g\ngoose_%s_seconds_count %llu\n";
+        const std::string STATS_COUNTER = "%s%s %llu (%.0f/s)";
+        const std::string STATS_TIMER = " | %s p50 %lluns p99 %lluns p999 %lluns";
+    }
+
+    /**
+      * Histogram class
+      */
+    std::uint64_t Histogram::quantile(const double q) const {
+        if (total == 0) {
+            return 0;
+        }
+        const std::uint64_t rank = std::max<std::uint64_t>(1, std::uint64_t(q * total + 0.5));
+        std::uint64_t seen = 0;
+        for (unsigned int bucket = 0; bucket < BUCKETS; ++bucket) {
+            seen += counts[bucket];
+            if (seen >= rank) {
+                return lowestOf(bucket);
+            }
+        }
+        return lowestOf(BUCKETS - 1);
+    }
+
+    /**
+      * ThreadMetrics
+      */
+    ThreadMetrics& registerThread() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        return registry.emplace_back();
+    }
+
+    /**
+      * Totals class
+      */
+    Totals Totals::collect() {
+        Totals totals;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const ThreadMetrics& metrics : registry) {
+            for (unsigned int counter = 0; counter < COUNTER_COUNT; ++counter) {
+                totals.counters[counter] += metrics.counters[counter].load(std::memory_order_relaxed);
+            }
+            for (unsigned int timer = 0; timer < TIMER_COUNT; ++timer) {
+                Histogram& histogram = totals.histograms[timer];
+                for (unsigned int bucket = 0; bucket < Histogram::BUCKETS; ++bucket) {
+                    std::uint64_t count = metrics.buckets[timer][bucket].load(std::memory_order_relaxed);
+                    if (count > 0) {
+                        histogram.add(bucket, count);
+                    }
+                }
+                histogram.addSum(metrics.sums[timer].load(std::memory_order_relaxed));
+            }
+        }
+        return totals;
+    }
+
+    void Totals::writePrometheus(mt::Sink& out) const {
+        for (unsigned int counter = 0; counter < COUNTER_COUNT; ++counter) {
+            mt::format_to(out, PROMETHEUS_COUNTER, COUNTER_NAMES[counter], COUNTER_NAMES[counter],
+                          static_cast<unsigned long long>(counters[counter]));
+        }
+        for (unsigned int timer = 0; timer < TIMER_COUNT; ++timer) {
+            const char* name = TIMER_NAMES[timer];
+            const Histogram& histogram = histograms[timer];
+            mt::format_to(out, PROMETHEUS_HISTOGRAM, name);
+            // only the buckets that were hit, as cumulative counts of their upper bound
+            std::uint64_t cumulative = 0;
+            for (unsigned int bucket = 0; bucket + 1 < Histogram::BUCKETS; ++bucket) {
+                if (histogram.getCount(bucket) > 0) {
+                    cumulative += histogram.getCount(bucket);
+                    mt::format_to(out, PROMETHEUS_BUCKET, name, (Histogram::lowestOf(bucket + 1) - 1) * 1e-9,
+                                  static_cast<unsigned long long>(cumulative));
+                }
+            }
+            mt::format_to(out, PROMETHEUS_TOTALS, name, static_cast<unsigned long long>(histogram.getCount()),
+                          name, histogram.getSum() * 1e-9, name, static_cast<unsigned long long>(histogram.getCount()));
+        }
+    }
+
+    void Totals::writeStatsLine(const Totals& previous, const double seconds, mt::Sink& out) const {
+        for (unsigned int counter = 0; counter < COUNTER_COUNT; ++counter) {
+            std::uint64_t delta = counters[counter] - previous.counters[counter];
+            mt::format_to(out, STATS_COUNTER, (counter > 0) ? " " : "", COUNTER_NAMES[counter],
+                          static_cast<unsigned long long>(counters[counter]), (seconds > 0) ? delta / seconds : 0.0);
+        }
+        for (unsigned int timer = 0; timer < TIMER_COUNT; ++timer) {
+            const Histogram& histogram = histograms[timer];
+            mt::format_to(out, STATS_TIMER, TIMER_NAMES[timer],
+                          static_cast<unsigned long long>(histogram.quantile(0.5)),
+                          static_cast<unsigned long long>(histogram.quantile(0.99)),
+                          static_cast<unsigned long long>(histogram.quantile(0.999)));
+        }
+        out.write("\n", 1);
+    }
+  } // namespace metrics
+} // namespace goose_game
@@ -0,0 +1,178 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "mt.hpp"
+
+/**
+  * Hot path instrumentation. Build with -DGOOSE_METRICS to record counts and
+  * latencies; without it the GOOSE_COUNT and GOOSE_TIME macros expand to nothing.
+  */
+#ifdef GOOSE_METRICS
+#define GOOSE_METRICS_CONCAT2(a, b) a##b
+#define GOOSE_METRICS_CONCAT(a, b) GOOSE_METRICS_CONCAT2(a, b)
+#define GOOSE_COUNT(counter, n) ::goose_game::metrics::count(::goose_game::metrics::counter, (n))
+#define GOOSE_TIME(timer) \
+    ::goose_game::metrics::ScopedTimer GOOSE_METRICS_CONCAT(gooseTimer, __LINE__)(::goose_game::metrics::timer)
+#else
+#define GOOSE_COUNT(counter, n) ((void) 0)
+#define GOOSE_TIME(timer) ((void) 0)
+#endif
+
+namespace goose_game {
+  namespace metrics {
+
+    enum Counter {
+        COMMANDS,
+        MOVES,
+        PRANKS,
+        GOOSE_HOPS,
+        BRIDGES,
+        BOUNCES,
+        DEATHS,
+        WINS,
+        COUNTER_COUNT
+    };
+
+    enum Timer {
+        COMMAND,
+        COMMAND_PARSE,
+        MOVE_RESOLVE,
+        NARRATION_RENDER,
+        TIMER_COUNT
+    };
+
+    /**
+      * Latency histogram in nanoseconds with HDR-style buckets: every power of two
+      * is split in SUB_BUCKETS linear buckets, so any value is known within 12.5%.
+      */
+    class Histogram {
+        public:
+            static constexpr unsigned int SUB_BITS = 3;
+            static constexpr unsigned int SUB_BUCKETS = 1u << SUB_BITS;
+            static constexpr unsigned int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+            static inline unsigned int bucketOf(const std::uint64_t value) {
+                if (value < SUB_BUCKETS) {
+                    return value;
+                }
+                const unsigned int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+                return (shift + 1) * SUB_BUCKETS + ((value >> shift) & (SUB_BUCKETS - 1));
+            }
+
+            // the smallest value falling in the bucket
+            static inline std::uint64_t lowestOf(const unsigned int bucket) {
+                if (bucket < SUB_BUCKETS) {
+                    return bucket;
+                }
+                const unsigned int shift = bucket / SUB_BUCKETS - 1;
+                return std::uint64_t(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+            }
+
+            inline void add(const unsigned int bucket, const std::uint64_t count) {
+                counts[bucket] += count;
+                total += count;
+            }
+
+            inline std::uint64_t getCount(const unsigned int bucket) const {
+                return counts[bucket];
+            }
+
+            inline std::uint64_t getCount() const {
+                return total;
+            }
+
+            inline std::uint64_t getSum() const {
+                return sum;
+            }
+
+            inline void addSum(const std::uint64_t nanos) {
+                sum += nanos;
+            }
+
+            // the lowest value of the bucket holding the quantile, 0 when empty
+            std::uint64_t quantile(const double q) const;
+        private:
+            std::uint64_t counts[BUCKETS] = {};
+            std::uint64_t total = 0;
+            std::uint64_t sum = 0;
+    };
+
+    /**
+      * The metrics of one thread: written by that thread only, with relaxed
+      * loads and stores instead of atomic increments, and read by any thread.
+      */
+    struct ThreadMetrics {
+        std::atomic<std::uint64_t> counters[COUNTER_COUNT] = {};
+        std::atomic<std::uint64_t> buckets[TIMER_COUNT][Histogram::BUCKETS] = {};
+        std::atomic<std::uint64_t> sums[TIMER_COUNT] = {};
+
+        static inline void bump(std::atomic<std::uint64_t>& value, const std::uint64_t n) {
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        inline void record(const Timer timer, const std::uint64_t nanos) {
+            bump(buckets[timer][Histogram::bucketOf(nanos)], 1);
+            bump(sums[timer], nanos);
+        }
+    };
+
+    // the block of the calling thread, registered on first use and kept after the thread ends
+    ThreadMetrics& registerThread();
+
+    inline ThreadMetrics& local() {
+        thread_local ThreadMetrics& metrics = registerThread();
+        return metrics;
+    }
+
+    inline void count(const Counter counter, const std::uint64_t n) {
+        ThreadMetrics::bump(local().counters[counter], n);
+    }
+
+    class ScopedTimer : private mt::NonAssignable {
+        public:
+            typedef std::chrono::steady_clock clock;
+
+            inline explicit ScopedTimer(const Timer timer) : timer(timer), start(clock::now()) {
+            }
+
+            inline ~ScopedTimer() {
+                auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+                local().record(timer, nanos);
+            }
+        private:
+            Timer timer;
+            clock::time_point start;
+    };
+
+    /**
+      * The sum of the metrics of every thread, at one point in time
+      */
+    class Totals {
+        public:
+            static Totals collect();
+
+            inline std::uint64_t get(const Counter counter) const {
+                return counters[counter];
+            }
+
+            inline const Histogram& get(const Timer timer) const {
+                return histograms[timer];
+            }
+
+            // Prometheus text exposition format
+            void writePrometheus(mt::Sink& out) const;
+
+            // one line with the counts and the latency quantiles, rates against the previous totals
+            void writeStatsLine(const Totals& previous, const double seconds, mt::Sink& out) const;
+        private:
+            std::uint64_t counters[COUNTER_COUNT] = {};
+            Histogram histograms[TIMER_COUNT];
+    };
+  } // namespace metrics
+} // namespace goose_game
+
+#endif //METRICS_H
@@ -1,10 +1,251 @@
 #include "mt.hpp"
+#include "rng.hpp"
+#include "work_pool.hpp"
 
 #include <memory>
 #include <iostream>
 #include <string>
 #include <cstdio>
+#include <cerrno>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace mt {
 
+  /**
+    * MappedFile class
+    */
+  MappedFile::MappedFile(const std::string& path) {
+      int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+          throw std::runtime_error(path + ": " + strerror(errno));
+      }
+      struct stat status;
+      if (::fstat(fd, &status) == 0) {
+          length = status.st_size;
+      }
+      if (length > 0) {
+          void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+          address = (mapping == MAP_FAILED) ? nullptr : static_cast<const char*>(mapping);
+      }
+      int mapError = errno;
+      ::close(fd);
+      if ( (length > 0) && (address == nullptr) ) {
+          throw std::runtime_error(path + ": " + strerror(mapError));
+      }
+  }
+
+  MappedFile::~MappedFile() {
+      if (address != nullptr) {
+          ::munmap(const_cast<char*>(address), length);
+      }
+  }
+
+  /**
+    * FileDescriptor class
+    */
+  FileDescriptor::~FileDescriptor() {
+      reset();
+  }
+
+  void FileDescriptor::reset(int fd) {
+      if (this->fd >= 0) {
+          ::close(this->fd);
+      }
+      this->fd = fd;
+  }
+
+  /**
+    * FdSink class
+    */
+  FdSink::FdSink(int fd, std::size_t capacity) : fd(fd), buffer(capacity) {
+  }
+
+  FdSink::~FdSink() {
+      try {
+          flush();
+      } catch (std::exception&) {
+          // nowhere left to report it
+      }
+  }
+
+  void FdSink::flush() {
+      writeAll(buffer.data(), used);
+      used = 0;
+  }
+
+  void FdSink::writeAll(const char* data, std::size_t size) {
+      while (size > 0) {
+          ssize_t written = ::write(fd, data, size);
+          if (written < 0) {
+              if (errno == EINTR) {
+                  continue;
+              }
+              throw std::runtime_error(std::string("write: ") + strerror(errno));
+          }
+          data += written;
+          size -= written;
+      }
+  }
+
+  /**
+    * WorkStealingPool class
+    */
+  WorkStealingPool::WorkStealingPool(unsigned int threadCount) {
+      if (threadCount == 0) {
+          threadCount = std::max(1u, std::thread::hardware_concurrency());
+      }
+      for (unsigned int worker = 0; worker < threadCount; ++worker) {
+          ranges.push_back(std::make_unique<Range>());
+      }
+      for (unsigned int worker = 1; worker < threadCount; ++worker) {
+          threads.emplace_back(&WorkStealingPool::loop, this, worker);
+      }
+  }
+
+  WorkStealingPool::~WorkStealingPool() {
+      {
+          std::lock_guard<std::mutex> guard(lock);
+          stopping = true;
+      }
+      wake.notify_all();
+      for (auto& thread : threads) {
+          thread.join();
+      }
+  }
+
+  void WorkStealingPool::parallelFor(std::size_t count, const std::function<void(std::size_t, unsigned int)>& task) {
+      if (count == 0) {
+          return;
+      }
+      const std::size_t workers = ranges.size();
+      for (std::size_t worker = 0; worker < workers; ++worker) {
+          std::lock_guard<std::mutex> guard(ranges[worker]->lock);
+          ranges[worker]->begin = count * worker / workers;
+          ranges[worker]->end = count * (worker + 1) / workers;
+      }
+      remaining.store(count, std::memory_order_relaxed);
+      {
+          std::lock_guard<std::mutex> guard(lock);
+          this->task = &task;
+          busy = workers - 1;
+          ++generation;
+      }
+      wake.notify_all();
+
+      work(0);
+
+      std::unique_lock<std::mutex> guard(lock);
+      done.wait(guard, [this]() { return busy == 0; });
+      this->task = nullptr;
+  }
+
+  void WorkStealingPool::loop(const unsigned int worker) {
+      std::uint64_t seen = 0;
+      while (true) {
+          {
+              std::unique_lock<std::mutex> guard(lock);
+              wake.wait(guard, [&]() { return stopping || (generation != seen); });
+              if (stopping) {
+                  return;
+              }
+              seen = generation;
+          }
+          work(worker);
+          std::lock_guard<std::mutex> guard(lock);
+          if (--busy == 0) {
+              done.notify_one();
+          }
+      }
+  }
+
+  void WorkStealingPool::work(const unsigned int worker) {
+      std::size_t index;
+      while (remaining.load(std::memory_order_acquire) > 0) {
+          if (take(worker, index)) {
+              (*task)(index, worker);
+              remaining.fetch_sub(1, std::memory_order_release);
+          } else if (!steal(worker)) {
+              // the last indexes are running elsewhere
+              std::this_thread::yield();
+          }
+      }
+  }
+
+  bool WorkStealingPool::take(const unsigned int worker, std::size_t& index) {
+      Range& range = *ranges[worker];
+      std::lock_guard<std::mutex> guard(range.lock);
+      if (range.begin == range.end) {
+          return false;
+      }
+      index = range.begin++;
+      return true;
+  }
+
+  bool WorkStealingPool::steal(const unsigned int worker) {
+      const unsigned int workers = ranges.size();
+      for (unsigned int offset = 1; offset < workers; ++offset) {
+          Range& victim = *ranges[(worker + offset) % workers];
+          std::size_t begin, end;
+          {
+              std::lock_guard<std::mutex> guard(victim.lock);
+              if (victim.begin == victim.end) {
+                  continue;
+              }
+              end = victim.end;
+              begin = end - (end - victim.begin + 1) / 2;
+              victim.end = begin;
+          }
+          // nobody steals from an empty range: this one is still ours alone
+          Range& own = *ranges[worker];
+          std::lock_guard<std::mutex> guard(own.lock);
+          own.begin = begin;
+          own.end = end;
+          steals.fetch_add(1, std::memory_order_relaxed);
+          return true;
+      }
+      return false;
+  }
+
+  /**
+    * Xoshiro256x4 class
+    */
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+  __attribute__((target_clones("avx2", "default")))
+#endif
+  void Xoshiro256x4::fill(std::uint64_t* __restrict out, std::size_t count) {
+      // the state stays in locals, out cannot alias it
+      std::uint64_t s0[STREAMS], s1[STREAMS], s2[STREAMS], s3[STREAMS];
+      for (std::size_t k = 0; k < STREAMS; ++k) {
+          s0[k] = s[0][k];
+          s1[k] = s[1][k];
+          s2[k] = s[2][k];
+          s3[k] = s[3][k];
+      }
+      for (std::size_t i = 0; i < count; i += STREAMS) {
+          // x * 5 and x * 9 as shifts: 64 bit lanes have no vector multiply before AVX-512
+          for (std::size_t k = 0; k < STREAMS; ++k) {
+              const std::uint64_t x = s1[k] + (s1[k] << 2);
+              const std::uint64_t r = (x << 7) | (x >> 57);
+              out[i + k] = r + (r << 3);
+              const std::uint64_t t = s1[k] << 17;
+              s2[k] ^= s0[k];
+              s3[k] ^= s1[k];
+              s1[k] ^= s2[k];
+              s0[k] ^= s3[k];
+              s2[k] ^= t;
+              s3[k] = (s3[k] << 45) | (s3[k] >> 19);
+          }
+      }
+      for (std::size_t k = 0; k < STREAMS; ++k) {
+          s[0][k] = s0[k];
+          s[1][k] = s1[k];
+          s[2][k] = s2[k];
+          s[3][k] = s3[k];
+      }
+  }
 }
@@ -8,7 +8,12 @@
 #include <functional>
 #include <cctype>
 #include <locale>
+#include <ostream>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
 #include <cstdarg>
 #include <cstring>
 
@@ -22,6 +27,48 @@ namespace mt {
     NonAssignable() {}
   };
 
+  /**
+    * Read-only memory mapping of a whole file, empty for an empty file
+    */
+  class MappedFile : private NonAssignable {
+  public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    inline const char* data() const {
+        return address;
+    }
+
+    inline std::size_t size() const {
+        return length;
+    }
+  private:
+    const char* address = nullptr;
+    std::size_t length = 0;
+  };
+
+  /**
+    * Owner of a file descriptor, closed on destruction; -1 when there is none
+    */
+  class FileDescriptor : private NonAssignable {
+  public:
+    explicit FileDescriptor(int fd = -1) : fd(fd) {}
+    ~FileDescriptor();
+
+    // closes the descriptor held, if any, and takes ownership of fd
+    void reset(int fd = -1);
+
+    inline int get() const {
+        return fd;
+    }
+
+    inline bool isOpen() const {
+        return fd >= 0;
+    }
+  private:
+    int fd;
+  };
+
   template<typename... Args>
   inline std::string string_format( const std::string& format, Args &&...args ) {
       std::size_t size = snprintf( nullptr, 0, format.c_str(), args ... ) + 1; // Extra space for '\0'
@@ -30,6 +77,136 @@ namespace mt {
       return std::string( buf.get(), buf.get() + size - 1 ); // We don't want the '\0' inside
   }
 
+  template<typename E>
+  struct Unexpected {
+    E error;
+  };
+
+  template<typename E>
+  inline Unexpected<E> unexpected(E error) {
+      return Unexpected<E>{std::move(error)};
+  }
+
+  /**
+    * Either a value or the error that prevented it, without exceptions;
+    * the subset of C++23 std::expected in use here
+    */
+  template<typename T, typename E>
+  class Expected {
+  public:
+    inline Expected(T value) : state(std::in_place_index<0>, std::move(value)) {};
+    inline Expected(Unexpected<E> failure) : state(std::in_place_index<1>, std::move(failure.error)) {};
+
+    inline bool has_value() const {
+        return state.index() == 0;
+    }
+
+    inline explicit operator bool() const {
+        return has_value();
+    }
+
+    inline const T& value() const {
+        return *std::get_if<0>(&state);
+    }
+
+    inline const T& operator*() const {
+        return value();
+    }
+
+    inline const T* operator->() const {
+        return std::get_if<0>(&state);
+    }
+
+    inline const E& error() const {
+        return *std::get_if<1>(&state);
+    }
+  private:
+    std::variant<T, E> state;
+  };
+
+  /**
+    * Destination of formatted text
+    */
+  class Sink {
+  public:
+    virtual ~Sink() {};
+    virtual void write(const char* data, std::size_t size) = 0;
+
+    inline void write(const std::string& text) {
+        write(text.data(), text.size());
+    };
+  };
+
+  // appends to a caller owned string, which can be cleared and reused
+  class StringSink : public Sink {
+  public:
+    inline explicit StringSink(std::string& target) : target(target) {};
+
+    using Sink::write;
+    inline virtual void write(const char* data, std::size_t size) {
+        target.append(data, size);
+    };
+  private:
+    std::string& target;
+  };
+
+  class OStreamSink : public Sink {
+  public:
+    inline explicit OStreamSink(std::ostream& target) : target(target) {};
+
+    using Sink::write;
+    inline virtual void write(const char* data, std::size_t size) {
+        target.write(data, size);
+    };
+  private:
+    std::ostream& target;
+  };
+
+  // collects the text in one large buffer, written to the file descriptor
+  // when full, on flush and on destruction
+  class FdSink : public Sink, private NonAssignable {
+  public:
+    explicit FdSink(int fd, std::size_t capacity = 1 << 20);
+    ~FdSink();
+
+    using Sink::write;
+    inline virtual void write(const char* data, std::size_t size) {
+        if (size > buffer.size() - used) {
+            flush();
+            if (size > buffer.size()) {
+                writeAll(data, size);
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+    };
+
+    void flush();
+  private:
+    void writeAll(const char* data, std::size_t size);
+
+    int fd;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+  };
+
+  // like string_format, but formats on the stack and writes to the sink;
+  // only texts longer than the stack buffer go through the heap
+  template<typename... Args>
+  inline void format_to( Sink& sink, const std::string& format, Args &&...args ) {
+      char buf[256];
+      int size = snprintf( buf, sizeof(buf), format.c_str(), args ... );
+      if ( size < 0 ) {
+          return;
+      }
+      if ( static_cast<std::size_t>(size) < sizeof(buf) ) {
+          sink.write( buf, size );
+      } else {
+          sink.write( string_format( format, args ... ) );
+      }
+  }
+
   template<class C>
   class const_range {
   public:
@@ -75,6 +252,27 @@ namespace mt {
       trim(s);
       return s;
   }
+
+  // std::isspace of the "C" locale, inlined
+  inline bool is_space(char c) {
+      return (c == ' ') || ( (c >= '\t') && (c <= '\r') );
+  }
+
+  // trim from both ends (viewing)
+  inline std::string_view trim_view(std::string_view s) {
+      std::size_t begin = 0, end = s.size();
+      while ( (begin < end) && is_space(s[begin]) ) {
+          ++begin;
+      }
+      while ( (end > begin) && is_space(s[end - 1]) ) {
+          --end;
+      }
+      return s.substr(begin, end - begin);
+  }
+
+  inline bool starts_with(std::string_view s, std::string_view prefix) {
+      return s.substr(0, prefix.size()) == prefix;
+  }
 }
 
 
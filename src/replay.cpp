@@ -0,0 +1,45 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "core.hpp"
+#include "journal.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+/*
+ * usage: goose_replay <journal> [game]
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cerr << "usage: goose_replay <journal> [game]" << endl;
+    return 1;
+  }
+
+  try {
+    auto start = chrono::steady_clock::now();
+    JournalReplay replay(argv[1]);
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "entries: " << replay.getEntryCount() << ", games in progress: " << replay.getGames().size()
+         << ", restored in " << elapsed.count() << " ms\n";
+
+    if (argc > 2) {
+      const JournalReplay::RestoredGame* game = replay.find(strtoul(argv[2], nullptr, 10));
+      if (game == nullptr) {
+        cerr << "no game " << argv[2] << " in progress" << endl;
+        return 1;
+      }
+      for (PlayerSlot slot = 0; slot < game->size(); ++slot) {
+        cout << game->names[slot] << ": " << game->positions[slot] << "\n";
+      }
+      if (game->hasWinner()) {
+        cout << "winner: " << game->names[game->winner] << "\n";
+      }
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+}
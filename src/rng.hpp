@@ -0,0 +1,106 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace mt {
+
+  // SplitMix64 step, used to expand a 64 bit seed into generator state
+  inline std::uint64_t splitmix64(std::uint64_t& state) {
+      std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+  }
+
+  // non deterministic 64 bit seed
+  inline std::uint64_t randomSeed() {
+      std::random_device rd;
+      return (std::uint64_t{rd()} << 32) ^ rd();
+  }
+
+  /**
+    * xoshiro256** generator (Blackman & Vigna), usable as a standard
+    * UniformRandomBitGenerator. Seeding is deterministic, and streamSeed()
+    * derives independent, counter-based streams from one master seed.
+    */
+  class Xoshiro256 {
+  public:
+    typedef std::uint64_t result_type;
+
+    inline explicit Xoshiro256(std::uint64_t seed = 0) {
+        this->seed(seed);
+    }
+
+    inline void seed(std::uint64_t seed) {
+        for (auto& word : s) {
+            word = splitmix64(seed);
+        }
+    }
+
+    // seed of the stream-th independent stream of a master seed
+    inline static std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream) {
+        std::uint64_t state = seed ^ splitmix64(stream);
+        return splitmix64(state);
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    inline result_type operator()() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+  private:
+    static inline std::uint64_t rotl(const std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t s[4];
+  };
+
+  /**
+    * Four xoshiro256** streams stepped side by side: the state is laid out
+    * word by stream, so fill() runs the four streams in vector registers.
+    */
+  class Xoshiro256x4 {
+  public:
+    static constexpr std::size_t STREAMS = 4;
+
+    inline explicit Xoshiro256x4(std::uint64_t seed = 0) {
+        this->seed(seed);
+    }
+
+    inline void seed(std::uint64_t seed) {
+        for (auto& word : s) {
+            for (auto& stream : word) {
+                stream = splitmix64(seed);
+            }
+        }
+    }
+
+    // writes count outputs, count being a multiple of STREAMS
+    void fill(std::uint64_t* out, std::size_t count);
+
+  private:
+    alignas(32) std::uint64_t s[4][STREAMS];
+  };
+}
+
+#endif //RNG_H
@@ -0,0 +1,94 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "journal.hpp"
+#include "metrics.hpp"
+#include "server.hpp"
+
+using namespace std;
+using namespace goose_game::server;
+
+namespace {
+  Server* running = nullptr;
+
+  void onSignal(int) {
+    if (running != nullptr) {
+      running->stop();
+    }
+  }
+
+#ifdef GOOSE_METRICS
+  const unsigned int STATS_PERIOD_SECONDS = 10;
+
+  // one stats line on the standard error every period, and a last one when done
+  void reportStats(const std::atomic<bool>& serving) {
+    using namespace goose_game;
+    typedef std::chrono::steady_clock clock;
+    metrics::Totals previous;
+    auto last = clock::now();
+    unsigned int ticks = 0;
+    while (true) {
+      bool done = !serving.load();
+      if (done || (++ticks % STATS_PERIOD_SECONDS == 0)) {
+        metrics::Totals totals = metrics::Totals::collect();
+        auto now = clock::now();
+        std::string line;
+        mt::StringSink out(line);
+        totals.writeStatsLine(previous, std::chrono::duration<double>(now - last).count(), out);
+        cerr << line;
+        previous = totals;
+        last = now;
+      }
+      if (done) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+  }
+#endif
+}
+
+/*
+ * usage: goose_server <port|unix-socket-path> [workers] [journal]
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cerr << "usage: goose_server <port|unix-socket-path> [workers] [journal]" << endl;
+    return 1;
+  }
+
+  try {
+    std::unique_ptr<goose_game::core::Journal> journal;
+    if (argc > 3) {
+      journal = std::make_unique<goose_game::core::Journal>(argv[3]);
+    }
+    Server server(argv[1], (argc > 2) ? strtoul(argv[2], nullptr, 10) : 0, journal.get());
+    running = &server;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    cout << "serving on " << argv[1] << " with " << server.getWorkerCount() << " workers" << endl;
+#ifdef GOOSE_METRICS
+    std::atomic<bool> serving {true};
+    std::thread reporter(reportStats, std::cref(serving));
+#endif
+    server.run();
+    running = nullptr;
+#ifdef GOOSE_METRICS
+    serving = false;
+    reporter.join();
+#endif
+    if (journal) {
+      journal->sync();
+    }
+  } catch (exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  cout << "bye!" << endl;
+}
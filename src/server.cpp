@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "mt.hpp"
+#include "view.hpp"
+#include "server.hpp"
+
+using namespace std;
+
+namespace goose_game {
+  namespace server {
+
+    namespace {
+        const std::size_t READ_BUFFER_SIZE = 64 * 1024;
+        // a longer command line closes the connection
+        const std::size_t MAX_LINE_SIZE = 64 * 1024;
+        const int MAX_EVENTS = 256;
+
+        std::runtime_error systemError(const std::string& what) {
+            return std::runtime_error(mt::string_format("%s: %s", what.c_str(), strerror(errno)));
+        }
+
+        void setNonBlocking(int fd) {
+            int flags = fcntl(fd, F_GETFL, 0);
+            if ( (flags < 0) || (fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) ) {
+                throw systemError("fcntl");
+            }
+        }
+
+        bool isNumber(const std::string& text) {
+            return !text.empty() && std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); });
+        }
+
+        // a client: its session plus the bytes still to be parsed or sent
+        struct Connection {
+            Connection(const std::shared_ptr<core::Players>& players, core::Journal* journal) : session(players, journal) {
+            }
+
+            view::Session session;
+            std::string input;
+            std::string output;
+            std::size_t sent = 0;
+            bool readClosed = false;    // the client half-closed: only the pending replies are left
+        };
+    }
+
+    /**
+      * Server::Worker
+      */
+    class Server::Worker {
+        public:
+            Worker(int listenFd, std::shared_ptr<core::Players> players, core::Journal* journal) :
+                listenFd(listenFd), players(std::move(players)), journal(journal), epollFd(epoll_create1(EPOLL_CLOEXEC)),
+                wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+                if ( !epollFd.isOpen() || !wakeFd.isOpen() ) {
+                    throw systemError("epoll");
+                }
+                // only one of the workers waiting on the socket is woken by a new client
+                watch(listenFd, EPOLLIN | EPOLLEXCLUSIVE);
+                watch(wakeFd.get(), EPOLLIN);
+            }
+
+            ~Worker() {
+                for (auto& pair : connections) {
+                    close(pair.first);
+                }
+            }
+
+            void run() {
+                epoll_event events[MAX_EVENTS];
+                while (running) {
+                    int count = epoll_wait(epollFd.get(), events, MAX_EVENTS, -1);
+                    if (count < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw systemError("epoll_wait");
+                    }
+                    for (int i = 0; i < count; ++i) {
+                        int fd = events[i].data.fd;
+                        if (fd == listenFd) {
+                            acceptAll();
+                        } else if (fd != wakeFd.get()) {
+                            serve(fd, events[i].events);
+                        }
+                    }
+                }
+            }
+
+            void stop() {
+                running = false;
+                std::uint64_t one = 1;
+                if (write(wakeFd.get(), &one, sizeof(one)) < 0) {
+                    // the worker is being woken up anyway
+                }
+            }
+        private:
+            void watch(int fd, std::uint32_t events) {
+                epoll_event event {};
+                event.events = events;
+                event.data.fd = fd;
+                if (epoll_ctl(epollFd.get(), EPOLL_CTL_ADD, fd, &event) < 0) {
+                    throw systemError("epoll_ctl");
+                }
+            }
+
+            void acceptAll() {
+                while (true) {
+                    int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0) {
+                        return; // EAGAIN: another worker took it, or no more clients
+                    }
+                    connections.emplace(std::piecewise_construct, std::forward_as_tuple(fd), std::forward_as_tuple(players, journal));
+                    watch(fd, EPOLLIN | EPOLLRDHUP);
+                }
+            }
+
+            void serve(int fd, std::uint32_t events) {
+                auto iter = connections.find(fd);
+                if (iter == connections.end()) {
+                    return;
+                }
+                Connection& connection = iter->second;
+                bool open = true;
+
+                if ( !connection.readClosed && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) ) {
+                    open = receive(fd, connection);
+                }
+                if (open) {
+                    open = flush(fd, connection);
+                }
+                if (!open) {
+                    epoll_ctl(epollFd.get(), EPOLL_CTL_DEL, fd, nullptr);
+                    close(fd);
+                    connections.erase(iter);
+                }
+            }
+
+            // reads and runs every complete command line; false when the client is gone or sent too long a line
+            bool receive(int fd, Connection& connection) {
+                char buffer[READ_BUFFER_SIZE];
+                while (true) {
+                    ssize_t size = read(fd, buffer, sizeof(buffer));
+                    if (size > 0) {
+                        connection.input.append(buffer, size);
+                        // lines are run as they come, so only an unfinished line stays buffered
+                        if (!execute(connection)) {
+                            return false;
+                        }
+                    } else if ( (size == 0) || ( (errno != EAGAIN) && (errno != EINTR) ) ) {
+                        connection.readClosed = true;
+                        return connection.output.size() > connection.sent;
+                    } else if (errno == EAGAIN) {
+                        return true;
+                    }
+                }
+            }
+
+            // runs the complete lines of the input; false when what is left is longer than a line may be
+            bool execute(Connection& connection) {
+                mt::StringSink out(connection.output);
+                std::size_t start = 0, end;
+                std::string line;
+                while ( !connection.session.isClosed()
+                        && ((end = connection.input.find('\n', start)) != std::string::npos) ) {
+                    line.assign(connection.input, start, end - start);
+                    if (!line.empty() && (line.back() == '\r')) {
+                        line.pop_back();
+                    }
+                    connection.session.execute(line, out);
+                    start = end + 1;
+                }
+                if (connection.session.isClosed()) {
+                    connection.input.clear();
+                    return true;
+                }
+                connection.input.erase(0, start);
+                return connection.input.size() <= MAX_LINE_SIZE;
+            }
+
+            // sends the pending replies; false once a closed session or a half-closed client has been fully answered
+            bool flush(int fd, Connection& connection) {
+                while (connection.sent < connection.output.size()) {
+                    ssize_t size = write(fd, connection.output.data() + connection.sent,
+                                         connection.output.size() - connection.sent);
+                    if (size < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        if (errno != EAGAIN) {
+                            return false;
+                        }
+                        // a half-closed read side stays readable, so it is no longer watched
+                        rearm(fd, connection.readClosed ? EPOLLOUT : (EPOLLIN | EPOLLRDHUP | EPOLLOUT));
+                        return true;
+                    }
+                    connection.sent += size;
+                }
+                connection.output.clear();
+                connection.sent = 0;
+                if (connection.readClosed || connection.session.isClosed()) {
+                    return false;
+                }
+                rearm(fd, EPOLLIN | EPOLLRDHUP);
+                return true;
+            }
+
+            void rearm(int fd, std::uint32_t events) {
+                epoll_event event {};
+                event.events = events;
+                event.data.fd = fd;
+                epoll_ctl(epollFd.get(), EPOLL_CTL_MOD, fd, &event);
+            }
+
+            int listenFd;
+            std::shared_ptr<core::Players> players;
+            core::Journal* journal;
+            mt::FileDescriptor epollFd;
+            mt::FileDescriptor wakeFd;
+            std::atomic<bool> running {true};
+            std::unordered_map<int, Connection> connections;
+    };
+
+    /**
+      * Server
+      */
+    Server::Server(const std::string& address, unsigned int workerCount, core::Journal* journal) :
+        players(std::make_shared<core::Players>()) {
+        if (isNumber(address)) {
+            listenFd.reset(socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0));
+            if (!listenFd.isOpen()) {
+                throw systemError("socket");
+            }
+            int yes = 1;
+            setsockopt(listenFd.get(), SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            sockaddr_in local {};
+            local.sin_family = AF_INET;
+            local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            local.sin_port = htons(std::stoi(address));
+            if (bind(listenFd.get(), reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+                throw systemError("bind " + address);
+            }
+        } else {
+            sockaddr_un local {};
+            if (address.size() >= sizeof(local.sun_path)) {
+                throw invalid_argument("address in Server constructor");
+            }
+            listenFd.reset(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+            if (!listenFd.isOpen()) {
+                throw systemError("socket");
+            }
+            local.sun_family = AF_UNIX;
+            std::strcpy(local.sun_path, address.c_str());
+            unlink(address.c_str());
+            if (bind(listenFd.get(), reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+                throw systemError("bind " + address);
+            }
+            unixPath = address;
+        }
+        setNonBlocking(listenFd.get());
+        if (listen(listenFd.get(), SOMAXCONN) < 0) {
+            throw systemError("listen");
+        }
+
+        if (workerCount == 0) {
+            workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned int i = 0; i < workerCount; ++i) {
+            workers.emplace_back(new Worker(listenFd.get(), players, journal));
+        }
+    }
+
+    Server::~Server() {
+        workers.clear();
+        listenFd.reset();
+        if (!unixPath.empty()) {
+            unlink(unixPath.c_str());
+        }
+    }
+
+    void Server::run() {
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < workers.size(); ++i) {
+            threads.emplace_back(&Worker::run, workers[i].get());
+        }
+        workers[0]->run();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void Server::stop() {
+        for (auto& worker : workers) {
+            worker->stop();
+        }
+    }
+  } // server
+} // goose_game
@@ -0,0 +1,54 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mt.hpp"
+
+namespace goose_game {
+  namespace core {
+    class Journal;
+    class Players;
+  }
+
+  namespace server {
+
+    /**
+      * Hosts one view::Session per connection on a TCP port of the loopback
+      * interface or on a Unix domain socket.
+      * Every worker thread runs its own epoll loop and owns the connections it
+      * accepts, so a session and its game are only touched by one thread.
+      * All the sessions register their players in one shared registry.
+      */
+    class Server {
+      public:
+        // address is either a port number or the path of a Unix domain socket;
+        // the games are logged to the journal, when given
+        Server(const std::string& address, unsigned int workerCount = 0, core::Journal* journal = nullptr);
+        ~Server();
+
+        // serves the clients until stop() is called
+        void run();
+
+        // can be called from any thread or from a signal handler
+        void stop();
+
+        inline unsigned int getWorkerCount() const {
+            return workers.size();
+        }
+      private:
+        class Worker;
+
+        mt::FileDescriptor listenFd;
+        std::string unixPath;
+        std::shared_ptr<core::Players> players;
+        std::vector<std::unique_ptr<Worker>> workers;
+    };
+  } // namespace server
+} // namespace goose_game
+
+#endif //SERVER_H
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define GOOSE_AVX2_KERNEL 1
+#endif
+
+#include "sim.hpp"
+#include "static_board.hpp"
+
+using namespace std;
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Simulator
+      */
+    Simulator::Simulator(std::shared_ptr<const Board> board, const unsigned int playerCount) :
+        board(std::move(board)), positions(playerCount, 0), dice{} {
+        if (playerCount == 0) {
+            throw invalid_argument("playerCount in Simulator constructor");
+        }
+    }
+
+    Simulator::Simulator(std::shared_ptr<const Board> board, const unsigned int playerCount, std::uint64_t seed) :
+        board(std::move(board)), positions(playerCount, 0), dice{seed} {
+        if (playerCount == 0) {
+            throw invalid_argument("playerCount in Simulator constructor");
+        }
+    }
+
+    GameResult Simulator::play() {
+        return board->isClassic() ? play(CLASSIC_BOARD) : play(*board);
+    }
+
+    template<class Layout>
+    GameResult Simulator::play(const Layout& board) {
+        GameResult result {0, 0, 0, 0};
+        const auto playerCount = positions.size();
+
+        std::fill(positions.begin(), positions.end(), 0);
+        while (true) {
+            for (std::size_t current = 0; current < playerCount; ++current) {
+                ++result.turns;
+                const auto dices = dice.roll() + dice.roll();
+                const auto oldPosition = positions[current];
+                const Board::Move& move = board.getMove(oldPosition, dices);
+                const Board::size_type newPosition = move.target;
+                result.bounces += move.bounces;
+
+                if ( (newPosition != oldPosition) && (newPosition != 0) ) {
+                    for (std::size_t other = 0; other < playerCount; ++other) {
+                        if ( (other != current) && (positions[other] == newPosition) ) {
+                            positions[other] = oldPosition;
+                            ++result.pranks;
+                            break;
+                        }
+                    }
+                }
+                positions[current] = newPosition;
+
+                if (move.wins) {
+                    result.winner = current;
+                    return result;
+                }
+            }
+        }
+    }
+
+    /**
+      * BatchSimulator
+      */
+    namespace {
+        const std::uint32_t WINS_FLAG = 0x100;
+        const std::uint32_t MOVES_PER_SPACE = Board::MAX_DICE - Board::MIN_DICE + 1;
+
+        /**
+          * One turn of the lanes [begin, end): the current player of every lane moves by
+          * its dice, pranks the first other player on the target space and passes the turn.
+          * won gets the winner + 1, or 0.
+          */
+        struct Lanes {
+            const std::uint32_t* targets;
+            const std::uint32_t* flags;
+            std::uint32_t* positions;
+            std::uint32_t* current;
+            const std::uint32_t* diceSums;
+            std::uint32_t* won;
+            std::uint32_t* turns;
+            std::uint32_t* pranks;
+            std::uint32_t* bounces;
+            std::size_t laneCount;
+            std::uint32_t playerCount;
+        };
+
+        void advanceScalar(const Lanes& lanes, std::size_t begin, std::size_t end) {
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                const std::uint32_t player = lanes.current[lane];
+                std::uint32_t* position = lanes.positions + lane;
+                const std::uint32_t oldPosition = position[player * lanes.laneCount];
+                const std::uint32_t move = oldPosition * MOVES_PER_SPACE + lanes.diceSums[lane] - Board::MIN_DICE;
+                const std::uint32_t newPosition = lanes.targets[move];
+
+                if ( (newPosition != oldPosition) && (newPosition != 0) ) {
+                    for (std::uint32_t other = 0; other < lanes.playerCount; ++other) {
+                        if ( (other != player) && (position[other * lanes.laneCount] == newPosition) ) {
+                            position[other * lanes.laneCount] = oldPosition;
+                            ++lanes.pranks[lane];
+                            break;
+                        }
+                    }
+                }
+                position[player * lanes.laneCount] = newPosition;
+
+                ++lanes.turns[lane];
+                lanes.bounces[lane] += lanes.flags[move] & 0xff;
+                lanes.won[lane] = (lanes.flags[move] & WINS_FLAG) ? player + 1 : 0;
+                lanes.current[lane] = (player + 1 == lanes.playerCount) ? 0 : player + 1;
+            }
+        }
+
+#ifdef GOOSE_AVX2_KERNEL
+        // the positions of a lane block are never gathered: every player row is
+        // loaded, compared and blended, so the current player needs no scatter
+        __attribute__((target("avx2")))
+        void advanceAvx2(const Lanes& lanes, std::size_t begin, std::size_t end) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i players = _mm256_set1_epi32(lanes.playerCount);
+            const __m256i movesPerSpace = _mm256_set1_epi32(MOVES_PER_SPACE);
+            const __m256i minDice = _mm256_set1_epi32(Board::MIN_DICE);
+            const __m256i bounceMask = _mm256_set1_epi32(0xff);
+            const __m256i winsFlag = _mm256_set1_epi32(WINS_FLAG);
+            const __m256i zero = _mm256_setzero_si256();
+
+            for (std::size_t lane = begin; lane < end; lane += BatchSimulator::LANE_BLOCK) {
+                auto at = [](std::uint32_t* p) { return reinterpret_cast<__m256i*>(p); };
+                const __m256i player = _mm256_loadu_si256(at(lanes.current + lane));
+
+                __m256i oldPosition = zero;
+                for (std::uint32_t row = 0; row < lanes.playerCount; ++row) {
+                    const __m256i isPlayer = _mm256_cmpeq_epi32(player, _mm256_set1_epi32(row));
+                    const __m256i position = _mm256_loadu_si256(at(lanes.positions + row * lanes.laneCount + lane));
+                    oldPosition = _mm256_blendv_epi8(oldPosition, position, isPlayer);
+                }
+
+                const __m256i dice = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.diceSums + lane));
+                const __m256i move = _mm256_add_epi32(_mm256_mullo_epi32(oldPosition, movesPerSpace),
+                                                      _mm256_sub_epi32(dice, minDice));
+                const __m256i newPosition = _mm256_i32gather_epi32(reinterpret_cast<const int*>(lanes.targets), move, 4);
+                const __m256i flags = _mm256_i32gather_epi32(reinterpret_cast<const int*>(lanes.flags), move, 4);
+                // nobody is pranked by a player who stays, or who goes back to Start
+                const __m256i noPrank = _mm256_or_si256(_mm256_cmpeq_epi32(newPosition, oldPosition),
+                                                        _mm256_cmpeq_epi32(newPosition, zero));
+
+                // the first other player on the target, in player order, goes back to oldPosition
+                __m256i pranked = noPrank;
+                for (std::uint32_t row = 0; row < lanes.playerCount; ++row) {
+                    __m256i* address = at(lanes.positions + row * lanes.laneCount + lane);
+                    const __m256i isPlayer = _mm256_cmpeq_epi32(player, _mm256_set1_epi32(row));
+                    __m256i position = _mm256_loadu_si256(address);
+                    const __m256i hit = _mm256_andnot_si256(_mm256_or_si256(pranked, isPlayer),
+                                                            _mm256_cmpeq_epi32(position, newPosition));
+                    pranked = _mm256_or_si256(pranked, hit);
+                    position = _mm256_blendv_epi8(position, oldPosition, hit);
+                    position = _mm256_blendv_epi8(position, newPosition, isPlayer);
+                    _mm256_storeu_si256(address, position);
+                }
+                // those lanes were marked pranked up front, without pranking anyone
+                const __m256i prankCount = _mm256_andnot_si256(noPrank, _mm256_and_si256(pranked, one));
+
+                __m256i* pranks = at(lanes.pranks + lane);
+                __m256i* turns = at(lanes.turns + lane);
+                __m256i* bounces = at(lanes.bounces + lane);
+                _mm256_storeu_si256(pranks, _mm256_add_epi32(_mm256_loadu_si256(pranks), prankCount));
+                _mm256_storeu_si256(turns, _mm256_add_epi32(_mm256_loadu_si256(turns), one));
+                _mm256_storeu_si256(bounces, _mm256_add_epi32(_mm256_loadu_si256(bounces), _mm256_and_si256(flags, bounceMask)));
+
+                const __m256i next = _mm256_add_epi32(player, one);
+                const __m256i wins = _mm256_cmpeq_epi32(_mm256_and_si256(flags, winsFlag), winsFlag);
+                _mm256_storeu_si256(at(lanes.won + lane), _mm256_and_si256(wins, next));
+                _mm256_storeu_si256(at(lanes.current + lane),
+                                    _mm256_andnot_si256(_mm256_cmpeq_epi32(next, players), next));
+            }
+        }
+#endif
+    }
+
+    BatchSimulator::BatchSimulator(std::shared_ptr<const Board> board, const unsigned int playerCount, const unsigned int lanes) :
+        playerCount(playerCount), board(std::move(board)) {
+        if ( (playerCount == 0) || (lanes == 0) ) {
+            throw invalid_argument("playerCount or lanes in BatchSimulator constructor");
+        }
+        const std::size_t laneCount = (lanes + LANE_BLOCK - 1) / LANE_BLOCK * LANE_BLOCK;
+
+        for (const Board::Move& move : this->board->getMoves()) {
+            targets.push_back(move.target);
+            flags.push_back(move.bounces | (move.wins ? WINS_FLAG : 0));
+        }
+        dice.resize(laneCount, Dice(0));
+        remaining.resize(laneCount, 0);
+        positions.resize(laneCount * playerCount, 0);
+        for (auto vector : {&current, &diceSums, &won, &turns, &pranks, &bounces}) {
+            vector->resize(laneCount, 0);
+        }
+    }
+
+    void BatchSimulator::assign(const unsigned int lane, std::uint64_t seed, std::uint64_t games) {
+        assert ( lane < current.size() );
+        if (isIdle(lane) && (games > 0)) {
+            ++activeCount;
+        } else if (!isIdle(lane) && (games == 0)) {
+            --activeCount;
+        }
+        dice[lane].seed(seed);
+        remaining[lane] = games;
+        reset(lane);
+    }
+
+    void BatchSimulator::reset(const unsigned int lane) {
+        for (unsigned int player = 0; player < playerCount; ++player) {
+            positions[player * current.size() + lane] = 0;
+        }
+        current[lane] = turns[lane] = pranks[lane] = bounces[lane] = 0;
+    }
+
+    void BatchSimulator::rollDice() {
+        for (std::size_t lane = 0; lane < dice.size(); ++lane) {
+            // idle lanes keep moving by MIN_DICE, their results are never reported
+            diceSums[lane] = isIdle(lane) ? Board::MIN_DICE : dice[lane].roll() + dice[lane].roll();
+        }
+    }
+
+    void BatchSimulator::advance() {
+        Lanes lanes {targets.data(), flags.data(), positions.data(), current.data(), diceSums.data(),
+                     won.data(), turns.data(), pranks.data(), bounces.data(), current.size(), playerCount};
+#ifdef GOOSE_AVX2_KERNEL
+        if (isVectorized()) {
+            advanceAvx2(lanes, 0, lanes.laneCount);
+            return;
+        }
+#endif
+        advanceScalar(lanes, 0, lanes.laneCount);
+    }
+
+    bool BatchSimulator::isVectorized() {
+#ifdef GOOSE_AVX2_KERNEL
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+#else
+        return false;
+#endif
+    }
+
+    GameResult BatchSimulator::finish(const unsigned int lane) {
+        GameResult result {won[lane] - 1, turns[lane], pranks[lane], bounces[lane]};
+        // the next game goes on with the same dice stream, as in Simulator::run
+        if (--remaining[lane] == 0) {
+            --activeCount;
+        }
+        reset(lane);
+        return result;
+    }
+
+    /**
+      * Statistics
+      */
+    Statistics::Statistics(const unsigned int playerCount) : wins(playerCount, 0) {
+    }
+
+    Statistics& Statistics::add(const GameResult& result) {
+        ++games;
+        turns += result.turns;
+        pranks += result.pranks;
+        bounces += result.bounces;
+        ++wins[result.winner];
+        if (result.turns >= lengths.size()) {
+            lengths.resize(result.turns + 1, 0);
+        }
+        ++lengths[result.turns];
+        return *this;
+    }
+
+    Statistics& Statistics::merge(const Statistics& other) {
+        assert ( wins.size() == other.wins.size() );
+        games += other.games;
+        turns += other.turns;
+        pranks += other.pranks;
+        bounces += other.bounces;
+        for (std::size_t i = 0; i < wins.size(); ++i) {
+            wins[i] += other.wins[i];
+        }
+        if (other.lengths.size() > lengths.size()) {
+            lengths.resize(other.lengths.size(), 0);
+        }
+        for (std::size_t i = 0; i < other.lengths.size(); ++i) {
+            lengths[i] += other.lengths[i];
+        }
+        return *this;
+    }
+
+    bool operator == (const Statistics& left, const Statistics& right) {
+        return (left.games == right.games) && (left.turns == right.turns)
+            && (left.pranks == right.pranks) && (left.bounces == right.bounces)
+            && (left.wins == right.wins) && (left.lengths == right.lengths);
+    }
+
+    /**
+      * MonteCarloRunner
+      */
+    MonteCarloRunner::MonteCarloRunner(std::shared_ptr<const Board> board, const unsigned int playerCount, std::uint64_t seed,
+                                       unsigned int threadCount, unsigned int lanes) :
+        board(std::move(board)), playerCount(playerCount), seed(seed),
+        threadCount(threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+        lanes(lanes) {
+        if (playerCount == 0) {
+            throw invalid_argument("playerCount in MonteCarloRunner constructor");
+        }
+    }
+
+    Statistics MonteCarloRunner::run(const std::uint64_t games) const {
+        const std::uint64_t chunks = (games + GAMES_PER_CHUNK - 1) / GAMES_PER_CHUNK;
+        std::atomic<std::uint64_t> nextChunk {0};
+        std::vector<Statistics> partials(threadCount, Statistics(playerCount));
+
+        auto worker = [&](Statistics& partial) {
+            // counters stay on the worker stack: no sharing until the final merge
+            Statistics local(playerCount);
+            if (lanes > 0) {
+                BatchSimulator batch(board, playerCount, lanes);
+                auto claim = [&](const unsigned int lane) {
+                    auto chunk = nextChunk++;
+                    if (chunk < chunks) {
+                        batch.assign(lane, mt::Xoshiro256::streamSeed(seed, chunk),
+                                     std::min(GAMES_PER_CHUNK, games - chunk * GAMES_PER_CHUNK));
+                    }
+                };
+                for (unsigned int lane = 0; lane < batch.getLaneCount(); ++lane) {
+                    claim(lane);
+                }
+                while (batch.getActiveCount() > 0) {
+                    batch.step([&](const unsigned int lane, const GameResult& result) {
+                        local.add(result);
+                        if (batch.isIdle(lane)) {
+                            claim(lane);
+                        }
+                    });
+                }
+            } else {
+                Simulator simulator(board, playerCount, seed);
+                for (auto chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+                    simulator.seed(mt::Xoshiro256::streamSeed(seed, chunk));
+                    simulator.run(std::min(GAMES_PER_CHUNK, games - chunk * GAMES_PER_CHUNK),
+                                  [&local](const GameResult& result) { local.add(result); });
+                }
+            }
+            partial = std::move(local);
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker, std::ref(partials[i]));
+        }
+        worker(partials[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            partials[0].merge(partials[i]);
+        }
+        return partials[0];
+    }
+  } // core
+} // goose_game
@@ -0,0 +1,165 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Compact outcome of a simulated game
+      */
+    struct GameResult {
+        std::uint32_t winner;   // index of the winning player
+        std::uint32_t turns;    // moves played by all the players together
+        std::uint32_t pranks;
+        std::uint32_t bounces;
+    };
+
+    /**
+      * Plays complete games through the move table of the Board,
+      * without producing any text.
+      */
+    class Simulator {
+        public:
+            Simulator(std::shared_ptr<const Board> board, const unsigned int playerCount);
+            Simulator(std::shared_ptr<const Board> board, const unsigned int playerCount, std::uint64_t seed);
+
+            inline void seed(std::uint64_t seed) {
+                dice.seed(seed);
+            }
+
+            GameResult play();
+
+            template<class Consumer>
+            void run(std::size_t games, Consumer&& consumer) {
+                while (games-- > 0) {
+                    consumer(play());
+                }
+            }
+
+            inline unsigned int getPlayerCount() const {
+                return positions.size();
+            }
+        private:
+            template<class Layout>
+            GameResult play(const Layout& layout);
+
+            std::shared_ptr<const Board> board;
+            std::vector<Board::size_type> positions;
+            Dice dice;
+    };
+
+    /**
+      * Plays many independent games in lockstep, one turn of every game per step.
+      * Every lane is a Simulator of its own: a lane assigned a seed reports the
+      * same GameResult, in the same order, as Simulator::run with that seed.
+      * Games are stored as structure of arrays and the move, prank and bounce
+      * rules run over blocks of LANE_BLOCK lanes with AVX2 when the CPU has it.
+      */
+    class BatchSimulator {
+        public:
+            static constexpr unsigned int LANE_BLOCK = 8;
+
+            // lanes are rounded up to a multiple of LANE_BLOCK, all of them idle
+            BatchSimulator(std::shared_ptr<const Board> board, const unsigned int playerCount, const unsigned int lanes);
+
+            // the lane plays games from a new dice stream until it has finished the given number
+            void assign(const unsigned int lane, std::uint64_t seed, std::uint64_t games);
+
+            inline bool isIdle(const unsigned int lane) const {
+                return remaining[lane] == 0;
+            }
+
+            inline unsigned int getLaneCount() const {
+                return current.size();
+            }
+
+            inline unsigned int getActiveCount() const {
+                return activeCount;
+            }
+
+            // one turn in every busy lane; consumer(lane, result) receives the finished games
+            template<class Consumer>
+            void step(Consumer&& consumer) {
+                rollDice();
+                advance();
+                for (unsigned int lane = 0; lane < won.size(); ++lane) {
+                    if ( (won[lane] != 0) && !isIdle(lane) ) {
+                        consumer(lane, finish(lane));
+                    }
+                }
+            }
+
+            // true when the AVX2 kernel is used
+            static bool isVectorized();
+        private:
+            void rollDice();
+            void advance();
+            void reset(const unsigned int lane);
+            GameResult finish(const unsigned int lane);
+
+            unsigned int playerCount;
+            unsigned int activeCount = 0;
+            std::shared_ptr<const Board> board;
+            std::vector<std::uint32_t> targets;     // Board::Move::target by move index
+            std::vector<std::uint32_t> flags;       // bounces, and WINS_FLAG
+            std::vector<Dice> dice;
+            std::vector<std::uint64_t> remaining;   // games left by lane
+            // by lane, positions by player then lane
+            std::vector<std::uint32_t> positions, current, diceSums, won, turns, pranks, bounces;
+    };
+
+    /**
+      * Aggregate of many GameResult. It only holds integer counters, so merging
+      * partial aggregates is exact and does not depend on the merge order.
+      */
+    struct Statistics {
+        explicit Statistics(const unsigned int playerCount);
+
+        Statistics& add(const GameResult& result);
+        Statistics& merge(const Statistics& other);
+
+        std::uint64_t games = 0;
+        std::uint64_t turns = 0;
+        std::uint64_t pranks = 0;
+        std::uint64_t bounces = 0;
+        std::vector<std::uint64_t> wins;     // by player index
+        std::vector<std::uint64_t> lengths;  // games by number of turns
+    };
+
+    bool operator == (const Statistics& left, const Statistics& right);
+
+    /**
+      * Plays a batch of games on all the cores.
+      * The batch is cut in chunks of GAMES_PER_CHUNK games and every chunk draws
+      * its dice from its own stream, derived from the seed and the chunk index:
+      * the same seed gives the same Statistics whatever the number of threads.
+      * With lanes, every thread plays that many chunks at once on a BatchSimulator.
+      */
+    class MonteCarloRunner {
+        public:
+            static const std::uint64_t GAMES_PER_CHUNK = 1024;
+
+            MonteCarloRunner(std::shared_ptr<const Board> board, const unsigned int playerCount, std::uint64_t seed,
+                             unsigned int threadCount = 0, unsigned int lanes = 0);
+
+            Statistics run(const std::uint64_t games) const;
+
+            inline unsigned int getThreadCount() const {
+                return threadCount;
+            }
+        private:
+            std::shared_ptr<const Board> board;
+            unsigned int playerCount;
+            std::uint64_t seed;
+            unsigned int threadCount;
+            unsigned int lanes;
+    };
+  } // namespace core
+} // namespace goose_game
+
+#endif //SIM_H
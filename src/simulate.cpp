@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core.hpp"
+#include "sim.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+namespace {
+  /**
+    * Plays the same seeded batch on one thread with plain Simulators, then on threadCount
+    * threads, and with BatchSimulator lanes on one and on threadCount threads: all the
+    * statistics must be identical
+    */
+  int check(const std::uint64_t games, const unsigned int playerCount, const std::uint64_t seed,
+            const unsigned int threadCount) {
+    const Statistics expected = MonteCarloRunner(Board::classic(), playerCount, seed, 1).run(games);
+    const std::string kernel = BatchSimulator::isVectorized() ? " (AVX2)" : " (scalar)";
+    const struct {
+      unsigned int threads;
+      unsigned int lanes;
+    } runs[] = {{threadCount, 0}, {1, BatchSimulator::LANE_BLOCK}, {threadCount, 13}};
+
+    int failures = 0;
+    for (const auto& run : runs) {
+      const MonteCarloRunner runner(Board::classic(), playerCount, seed, run.threads, run.lanes);
+      const bool same = (runner.run(games) == expected);
+      cout << "threads: " << runner.getThreadCount();
+      if (run.lanes > 0) {
+        cout << ", lanes: " << run.lanes << kernel;
+      }
+      cout << (same ? ", same as" : ", DIFFERENT from") << " 1 thread without lanes\n";
+      failures += !same;
+    }
+    return (failures == 0) ? 0 : 1;
+  }
+}
+
+/*
+ * usage: goose_sim [games] [players] [seed] [threads] [lanes]
+ *        goose_sim --check [games] [players] [seed] [threads]
+ */
+int main(int argc, char* argv[]) {
+  if ( (argc > 1) && (string(argv[1]) == "--check") ) {
+    const std::uint64_t games = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 100000;
+    const unsigned int playerCount = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 4;
+    const std::uint64_t seed = (argc > 4) ? strtoull(argv[4], nullptr, 10) : mt::randomSeed();
+    const unsigned int threadCount = (argc > 5) ? strtoul(argv[5], nullptr, 10) : 4;
+    if ( (games == 0) || (playerCount == 0) ) {
+      cerr << "usage: goose_sim --check [games] [players] [seed] [threads]" << endl;
+      return 1;
+    }
+    cout << "games: " << games << ", players: " << playerCount << ", seed: " << seed << "\n";
+    return check(games, playerCount, seed, threadCount);
+  }
+
+  const std::uint64_t games = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 1000000;
+  const unsigned int playerCount = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 4;
+  const std::uint64_t seed = (argc > 3) ? strtoull(argv[3], nullptr, 10) : mt::randomSeed();
+  const unsigned int threadCount = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 0;
+  const unsigned int lanes = (argc > 5) ? strtoul(argv[5], nullptr, 10) : 0;
+
+  if ( (games == 0) || (playerCount == 0) ) {
+    cerr << "usage: goose_sim [games] [players] [seed] [threads] [lanes]" << endl;
+    return 1;
+  }
+
+  MonteCarloRunner runner(Board::classic(), playerCount, seed, threadCount, lanes);
+
+  auto start = chrono::steady_clock::now();
+  Statistics stats = runner.run(games);
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  cout << "games: " << games << ", players: " << playerCount
+       << ", seed: " << seed << ", threads: " << runner.getThreadCount();
+  if (lanes > 0) {
+    cout << ", lanes: " << lanes << (BatchSimulator::isVectorized() ? " (AVX2)" : " (scalar)");
+  }
+  cout << "\n"
+       << "elapsed: " << elapsed.count() << " s, " << (games / elapsed.count()) << " games/sec\n"
+       << "turns/game: " << (double(stats.turns) / games)
+       << ", pranks/game: " << (double(stats.pranks) / games)
+       << ", bounces/game: " << (double(stats.bounces) / games) << "\n";
+  for (unsigned int i = 0; i < playerCount; ++i) {
+    cout << "player " << i << " wins: " << (100.0 * stats.wins[i] / games) << "%\n";
+  }
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "core.hpp"
+#include "snapshot.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+namespace {
+  double millisecondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+  }
+}
+
+/*
+ * usage: goose_snapshot save <path> [players] [games]
+ *        goose_snapshot load <path> [player-name]
+ */
+int main(int argc, char* argv[]) {
+  const string command = (argc > 2) ? argv[1] : "";
+  try {
+    if (command == "save") {
+      const unsigned long playerCount = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 1000000;
+      const unsigned long gameCount = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 1;
+      App app;
+      for (unsigned long i = 0; i < playerCount; ++i) {
+        app.getPlayers().addPlayer(Player("player" + to_string(i)));
+      }
+      vector<GamePool::handle_type> games;
+      while (games.size() < gameCount) {
+        games.push_back(app.acquireGame());
+        for (PlayerSlot slot = 0; slot < min<PlayerSlot>(games.back()->getPlayers().size(), 64); ++slot) {
+          games.back()->move(slot);
+        }
+      }
+
+      auto start = chrono::steady_clock::now();
+      Snapshot::save(app, argv[2]);
+      cout << "saved " << playerCount << " players and " << gameCount << " games in "
+           << millisecondsSince(start) << " ms\n";
+    } else if (command == "load") {
+      auto start = chrono::steady_clock::now();
+      SnapshotView snapshot(argv[2]);
+      cout << "mapped " << snapshot.getPlayerCount() << " players and " << snapshot.getGameCount()
+           << " games in " << millisecondsSince(start) << " ms\n";
+      if (argc > 3) {
+        PlayerId id = snapshot.findPlayer(argv[3]);
+        cout << argv[3] << ": " << ((id != Players::NO_PLAYER) ? "id " + to_string(id) : "not found") << "\n";
+      }
+
+      start = chrono::steady_clock::now();
+      App app;
+      auto games = Snapshot::restore(snapshot, app);
+      cout << "restored the App with " << games.size() << " games in " << millisecondsSince(start) << " ms\n";
+    } else {
+      cerr << "usage: goose_snapshot save <path> [players] [games]\n"
+              "       goose_snapshot load <path> [player-name]" << endl;
+      return 1;
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+}
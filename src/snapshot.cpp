@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "snapshot.hpp"
+
+using namespace std;
+
+namespace goose_game {
+  namespace core {
+
+    namespace {
+        const char MAGIC[8] = {'G', 'O', 'O', 'S', 'E', 'S', 'N', 'P'};
+        const std::uint32_t VERSION = 2;
+
+        inline std::size_t aligned(std::size_t size) {
+            return (size + 7) & ~std::size_t(7);
+        }
+
+        invalid_argument error(const std::string& path, const std::string& reason) {
+            return invalid_argument(path + ": " + reason);
+        }
+
+        // throws unless the game can be played on: its players sorted and saved, its positions
+        // on the board, none but Start shared, and the winner one of its players
+        void checkGame(const SnapshotView& snapshot, const SnapshotView::GameHeader& saved, const Board& board) {
+            const std::uint32_t* ids = snapshot.getPlayerIds(saved);
+            for (PlayerSlot slot = 0; slot < saved.playerCount; ++slot) {
+                if ( (ids[slot] >= snapshot.getPlayerCount()) || ((slot > 0) && (ids[slot - 1] >= ids[slot])) ) {
+                    throw invalid_argument("players of a game in Snapshot::restore");
+                }
+            }
+            if ( ((saved.winner != GamePlayers::NO_SLOT) && (saved.winner >= saved.playerCount))
+                    || (saved.spaceCount != board.getSpaces().size()) ) {
+                throw invalid_argument("game in Snapshot::restore");
+            }
+            const std::uint32_t* positions = snapshot.getPositions(saved);
+            std::vector<bool> occupied(board.getLastIndex() + 1, false);
+            for (PlayerSlot slot = 0; slot < saved.playerCount; ++slot) {
+                if ( (positions[slot] > board.getLastIndex()) || ((positions[slot] > 0) && occupied[positions[slot]]) ) {
+                    throw invalid_argument("positions of a game in Snapshot::restore");
+                }
+                occupied[positions[slot]] = true;
+            }
+        }
+    }
+
+    /**
+      * SnapshotView
+      */
+    SnapshotView::SnapshotView(const std::string& path) : file(path) {
+        if (file.size() < sizeof(header)) {
+            throw error(path, "truncated snapshot");
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if ( (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) || (header.version != VERSION) ) {
+            throw error(path, "not a snapshot of this version");
+        }
+        const std::uint64_t size = file.size();
+        const bool fits = (header.fileSize == size)
+            && (header.playerCount < size) && (header.indexSize < size) && (header.gameCount < size)
+            && (header.nameOffsetsAt + (header.playerCount + 1) * sizeof(std::uint64_t) <= size)
+            && (header.indexAt + header.indexSize * sizeof(std::uint32_t) <= size)
+            && (header.shardOffsetsAt + (Players::SHARD_COUNT + 1) * sizeof(std::uint64_t) <= size)
+            && (header.gameOffsetsAt + header.gameCount * sizeof(std::uint64_t) <= size)
+            && (header.indexSize >= 2 * header.playerCount);
+        if (!fits) {
+            throw error(path, "corrupted snapshot");
+        }
+        shardOffsets = reinterpret_cast<const std::uint64_t*>(file.data() + header.shardOffsetsAt);
+        if ( (shardOffsets[0] != 0) || (shardOffsets[Players::SHARD_COUNT] != header.indexSize) ) {
+            throw error(path, "corrupted snapshot");
+        }
+        for (unsigned int shard = 0; shard < Players::SHARD_COUNT; ++shard) {
+            const std::uint64_t shardSize = shardOffsets[shard + 1] - shardOffsets[shard];
+            if ( (shardOffsets[shard + 1] < shardOffsets[shard]) || ((shardSize & (shardSize - 1)) != 0) ) {
+                throw error(path, "corrupted snapshot");
+            }
+        }
+        nameOffsets = reinterpret_cast<const std::uint64_t*>(file.data() + header.nameOffsetsAt);
+        names = file.data() + header.namesAt;
+        index = reinterpret_cast<const std::uint32_t*>(file.data() + header.indexAt);
+        gameOffsets = reinterpret_cast<const std::uint64_t*>(file.data() + header.gameOffsetsAt);
+        // names and indexes are read without further checks: every offset and bucket must stay in the file
+        if ( (nameOffsets[0] != 0) || (header.namesAt > size) || (nameOffsets[header.playerCount] > size - header.namesAt) ) {
+            throw error(path, "corrupted snapshot");
+        }
+        for (std::uint64_t id = 0; id < header.playerCount; ++id) {
+            if (nameOffsets[id + 1] < nameOffsets[id]) {
+                throw error(path, "corrupted snapshot");
+            }
+        }
+        for (std::uint64_t bucket = 0; bucket < header.indexSize; ++bucket) {
+            if (index[bucket] > header.playerCount) {
+                throw error(path, "corrupted snapshot");
+            }
+        }
+        // every game, its ids and its positions within the file, past the game offsets
+        const std::uint64_t gamesAt = header.gameOffsetsAt + header.gameCount * sizeof(std::uint64_t);
+        for (std::uint64_t game = 0; game < header.gameCount; ++game) {
+            const std::uint64_t offset = gameOffsets[game];
+            if ( (offset < gamesAt) || (offset % alignof(GameHeader) != 0) || (offset > size - sizeof(GameHeader)) ) {
+                throw error(path, "corrupted snapshot");
+            }
+            GameHeader saved;
+            std::memcpy(&saved, file.data() + offset, sizeof(saved));
+            if (2 * std::uint64_t(saved.playerCount) * sizeof(std::uint32_t) > size - offset - sizeof(GameHeader)) {
+                throw error(path, "corrupted snapshot");
+            }
+        }
+    }
+
+    PlayerId SnapshotView::findPlayer(std::string_view name) const {
+        const std::uint64_t hash = Players::hashName(name);
+        const unsigned int shard = Players::shardOf(hash);
+        const std::uint32_t* buckets = index + shardOffsets[shard];
+        const std::uint64_t shardSize = shardOffsets[shard + 1] - shardOffsets[shard];
+        // a corrupted file may have a full shard: never probe more than its size
+        std::uint64_t bucket = hash & (shardSize - 1);
+        for (std::uint64_t probes = 0; (probes < shardSize) && (buckets[bucket] != 0); ++probes, bucket = (bucket + 1) & (shardSize - 1)) {
+            const PlayerId id = buckets[bucket] - 1;
+            if (getName(id) == name) {
+                return id;
+            }
+        }
+        return Players::NO_PLAYER;
+    }
+
+    const SnapshotView::GameHeader& SnapshotView::getGame(const std::uint64_t game) const {
+        assert ( game < header.gameCount );
+        return *reinterpret_cast<const GameHeader*>(file.data() + gameOffsets[game]);
+    }
+
+    /**
+      * Snapshot
+      */
+    void Snapshot::save(const App& app, const std::string& path) {
+        save(app.getPlayers(), app.getPool().getActive(), path);
+    }
+
+    void Snapshot::save(const Players& players, const std::vector<const Game*>& games, const std::string& path) {
+        SnapshotView::Header header {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.playerCount = players.size();
+        header.gameCount = games.size();
+        // the indexes of the registry are saved as they are, so restoring never hashes a name
+        std::uint64_t shardOffsets[Players::SHARD_COUNT + 1] = {0};
+        for (unsigned int shard = 0; shard < Players::SHARD_COUNT; ++shard) {
+            shardOffsets[shard + 1] = shardOffsets[shard] + players.getIndex(shard).size();
+        }
+        header.indexSize = shardOffsets[Players::SHARD_COUNT];
+
+        std::size_t namesSize = 0;
+        for (const Player& player : players.getAll()) {
+            namesSize += player.getName().size();
+        }
+        header.nameOffsetsAt = aligned(sizeof(header));
+        header.namesAt = header.nameOffsetsAt + (header.playerCount + 1) * sizeof(std::uint64_t);
+        header.indexAt = aligned(header.namesAt + namesSize);
+        header.shardOffsetsAt = header.indexAt + aligned(header.indexSize * sizeof(std::uint32_t));
+        header.gameOffsetsAt = header.shardOffsetsAt + sizeof(shardOffsets);
+        header.fileSize = header.gameOffsetsAt + header.gameCount * sizeof(std::uint64_t);
+        for (const Game* game : games) {
+            header.fileSize += sizeof(SnapshotView::GameHeader)
+                + aligned(2 * game->getPlayers().size() * sizeof(std::uint32_t));
+        }
+
+        std::string bytes(header.fileSize, '\0');
+        char* data = bytes.data();
+        std::memcpy(data, &header, sizeof(header));
+
+        std::uint64_t* nameOffsets = reinterpret_cast<std::uint64_t*>(data + header.nameOffsetsAt);
+        std::uint64_t offset = 0;
+        PlayerId id = 0;
+        for (const Player& player : players.getAll()) {
+            const std::string& name = player.getName();
+            nameOffsets[id++] = offset;
+            std::memcpy(data + header.namesAt + offset, name.data(), name.size());
+            offset += name.size();
+        }
+        nameOffsets[id] = offset;
+        for (unsigned int shard = 0; shard < Players::SHARD_COUNT; ++shard) {
+            const std::vector<PlayerId>& index = players.getIndex(shard);
+            std::memcpy(data + header.indexAt + shardOffsets[shard] * sizeof(PlayerId), index.data(),
+                        index.size() * sizeof(PlayerId));
+        }
+        std::memcpy(data + header.shardOffsetsAt, shardOffsets, sizeof(shardOffsets));
+
+        std::uint64_t* gameOffsets = reinterpret_cast<std::uint64_t*>(data + header.gameOffsetsAt);
+        offset = header.gameOffsetsAt + header.gameCount * sizeof(std::uint64_t);
+        for (std::size_t i = 0; i < games.size(); ++i) {
+            const GamePlayers& gamePlayers = games[i]->getPlayers();
+            SnapshotView::GameHeader game {games[i]->getWinnerSlot(), gamePlayers.size(),
+                                           static_cast<std::uint32_t>(games[i]->getBoard().getSpaces().size()), 0};
+            gameOffsets[i] = offset;
+            std::memcpy(data + offset, &game, sizeof(game));
+            std::uint32_t* ids = reinterpret_cast<std::uint32_t*>(data + offset + sizeof(game));
+            for (PlayerSlot slot = 0; slot < game.playerCount; ++slot) {
+                ids[slot] = gamePlayers.getPlayerId(slot);
+                ids[game.playerCount + slot] = gamePlayers.getPosition(slot);
+            }
+            offset += sizeof(game) + aligned(2 * game.playerCount * sizeof(std::uint32_t));
+        }
+
+        // synced before the rename, so a crash leaves either the old snapshot or the whole new one
+        const std::string temporary = path + ".tmp";
+        {
+            mt::FileDescriptor out(open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+            if (!out.isOpen()) {
+                throw error(temporary, strerror(errno));
+            }
+            for (std::size_t written = 0; written < bytes.size(); ) {
+                const ssize_t count = write(out.get(), bytes.data() + written, bytes.size() - written);
+                if ( (count < 0) && (errno != EINTR) ) {
+                    const int cause = errno;
+                    unlink(temporary.c_str());
+                    throw error(temporary, strerror(cause));
+                }
+                written += std::max<ssize_t>(count, 0);
+            }
+            if (fsync(out.get()) != 0) {
+                const int cause = errno;
+                unlink(temporary.c_str());
+                throw error(temporary, strerror(cause));
+            }
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw error(path, strerror(errno));
+        }
+    }
+
+    void Snapshot::restore(const SnapshotView& snapshot, Players& players) {
+        if (!players.isEmpty()) {
+            throw invalid_argument("players in Snapshot::restore");
+        }
+        Players restored;
+        if (snapshot.getPlayerCount() > 0) {
+            restored.restore(snapshot.getPlayerCount(), [&snapshot](PlayerId id) { return snapshot.getName(id); },
+                             snapshot.index, snapshot.shardOffsets);
+        }
+        players.swap(restored);
+    }
+
+    std::vector<GamePool::handle_type> Snapshot::restore(const SnapshotView& snapshot, App& app) {
+        if (!app.getPlayers().isEmpty()) {
+            throw invalid_argument("players in Snapshot::restore");
+        }
+        for (std::uint64_t i = 0; i < snapshot.getGameCount(); ++i) {
+            checkGame(snapshot, snapshot.getGame(i), *Board::classic());
+        }
+        restore(snapshot, app.getPlayers());
+
+        std::vector<GamePool::handle_type> games;
+        try {
+            games.reserve(snapshot.getGameCount());
+            for (std::uint64_t i = 0; i < snapshot.getGameCount(); ++i) {
+                const SnapshotView::GameHeader& saved = snapshot.getGame(i);
+                games.push_back(app.getPool().acquire(snapshot.getPlayerIds(saved), snapshot.getPositions(saved),
+                                                      saved.playerCount, saved.winner));
+            }
+        } catch (...) {
+            // the games go back to the pool before their players leave
+            games.clear();
+            Players restored;
+            app.getPlayers().swap(restored);
+            throw;
+        }
+        return games;
+    }
+  }
+}
@@ -0,0 +1,107 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Read-only view of a snapshot file, used in place through a memory mapping.
+      *
+      * The file is flat and every section is found by offset from its header:
+      *   - name offsets, uint64[playerCount + 1], into the names blob
+      *   - the names blob
+      *   - the open addressing indexes of the names, one per shard of Players,
+      *     uint32 player id + 1 (0 is empty), back to back
+      *   - the offsets of the shards into the indexes, uint64[SHARD_COUNT + 1]
+      *   - game offsets, uint64[gameCount], each game being a GameHeader
+      *     followed by uint32 player ids and uint32 positions
+      * Integers are in native byte order.
+      */
+    class SnapshotView : private mt::NonAssignable {
+        public:
+            struct GameHeader {
+                std::uint32_t winner;       // slot, or GamePlayers::NO_SLOT
+                std::uint32_t playerCount;
+                std::uint32_t spaceCount;   // of the board the game was played on
+                std::uint32_t reserved;
+            };
+
+            explicit SnapshotView(const std::string& path);
+
+            inline PlayerId getPlayerCount() const {
+                return header.playerCount;
+            }
+
+            inline std::string_view getName(const PlayerId id) const {
+                assert ( id < header.playerCount );
+                return std::string_view(names + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+            }
+
+            // Players::NO_PLAYER when there is no such name
+            PlayerId findPlayer(std::string_view name) const;
+
+            inline std::uint64_t getGameCount() const {
+                return header.gameCount;
+            }
+
+            const GameHeader& getGame(const std::uint64_t game) const;
+
+            inline const std::uint32_t* getPlayerIds(const GameHeader& game) const {
+                return reinterpret_cast<const std::uint32_t*>(&game + 1);
+            }
+
+            inline const std::uint32_t* getPositions(const GameHeader& game) const {
+                return getPlayerIds(game) + game.playerCount;
+            }
+        private:
+            friend class Snapshot;
+
+            struct Header {
+                char magic[8];
+                std::uint32_t version;
+                std::uint32_t reserved;
+                std::uint64_t playerCount;
+                std::uint64_t nameOffsetsAt;
+                std::uint64_t namesAt;
+                std::uint64_t indexAt;
+                std::uint64_t indexSize;     // of all the shards together
+                std::uint64_t shardOffsetsAt;
+                std::uint64_t gameCount;
+                std::uint64_t gameOffsetsAt;
+                std::uint64_t fileSize;
+            };
+
+            mt::MappedFile file;
+            Header header;
+            const std::uint64_t* nameOffsets;
+            const char* names;
+            const std::uint32_t* index;
+            const std::uint64_t* shardOffsets;
+            const std::uint64_t* gameOffsets;
+    };
+
+    /**
+      * Saves and restores the players and the games in progress of an App
+      */
+    class Snapshot final {
+        public:
+            // written and synced to a temporary file first, then renamed over path; no player may be added meanwhile
+            static void save(const App& app, const std::string& path);
+            static void save(const Players& players, const std::vector<const Game*>& games, const std::string& path);
+
+            // the App must have no players yet: its games in progress are returned.
+            // Everything is checked and the players are built aside first: on failure the App is left empty
+            static std::vector<GamePool::handle_type> restore(const SnapshotView& snapshot, App& app);
+            static void restore(const SnapshotView& snapshot, Players& players);
+    };
+  }
+}
+
+#endif //SNAPSHOT_H
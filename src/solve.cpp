@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "core.hpp"
+#include "layout.hpp"
+#include "markov.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+/*
+ * usage: goose_solve [spaces | board-file]
+ */
+int main(int argc, char* argv[]) {
+  char* end = nullptr;
+  Board::size_type spaces = (argc > 1) ? strtoul(argv[1], &end, 10) : Consts::SPACE_COUNT;
+  std::shared_ptr<const Board> board;
+  if ( (argc > 1) && (*end != '\0') ) {
+    try {
+      board = BoardFile::load(argv[1]);
+    } catch (const exception& e) {
+      cerr << e.what() << endl;
+      return 1;
+    }
+    spaces = board->getSpaces().size();
+  } else if (spaces <= Consts::GOOSES.back()) {
+    cerr << "usage: goose_solve [spaces | board-file], with more than " << Consts::GOOSES.back() << " spaces" << endl;
+    return 1;
+  } else {
+    board = std::make_shared<const Board>(spaces, Consts::BRIDGES, Consts::GOOSES);
+  }
+
+  auto start = chrono::steady_clock::now();
+  MarkovAnalysis analysis;
+  try {
+    analysis = MarkovSolver(board).solve();
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+  cout << "spaces: " << spaces << ", solved in " << elapsed.count() << " ms\n"
+       << "expected turns from Start: " << analysis.expectedTurns << "\n";
+
+  double cumulative = 0.0;
+  for (double quantile : {0.5, 0.9, 0.99}) {
+    std::size_t turn = 0;
+    cumulative = 0.0;
+    while ( (cumulative < quantile) && (++turn < analysis.finishByTurn.size()) ) {
+      cumulative += analysis.finishByTurn[turn];
+    }
+    cout << "finishes within " << turn << " turns with probability " << quantile << "\n";
+  }
+
+  Board::size_type mostVisited = 1;
+  for (Board::size_type space = 1; space < board->getLastIndex(); ++space) {
+    if (analysis.visits[space] > analysis.visits[mostVisited]) {
+      mostVisited = space;
+    }
+  }
+  cout << "most visited space: " << mostVisited << " (" << analysis.visits[mostVisited] << " visits per game)\n";
+}
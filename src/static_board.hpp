@@ -0,0 +1,117 @@
+#ifndef STATIC_BOARD_H
+#define STATIC_BOARD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    template<std::uint32_t... Indexes>
+    using SpaceList = std::integer_sequence<std::uint32_t, Indexes...>;
+
+    template<std::uint32_t Size, class Gooses, class Bridges>
+    class StaticBoard;
+
+    /**
+      * Board layout fixed at compile time: the spaces and the whole move
+      * table are constant data, built by the same rule walk as Board.
+      * Bridges jump forward by Consts::BRIDGE_SPACES_TO_ADVANCE.
+      */
+    template<std::uint32_t Size, std::uint32_t... Gooses, std::uint32_t... Bridges>
+    class StaticBoard<Size, SpaceList<Gooses...>, SpaceList<Bridges...>> {
+        public:
+            typedef Board::size_type size_type;
+
+            static constexpr size_type MIN_DICE = Board::MIN_DICE;
+            static constexpr size_type MAX_DICE = Board::MAX_DICE;
+            static constexpr size_type MOVES_PER_SPACE = MAX_DICE - MIN_DICE + 1;
+
+            static_assert(Size > MAX_DICE, "StaticBoard needs more spaces than the highest dice sum");
+            static_assert(((Gooses > 0 && Gooses + 1 < Size) && ...), "Gooses in StaticBoard");
+            static_assert(((Bridges > 0 && Bridges + 1 < Size) && ...), "Bridges in StaticBoard");
+            static_assert(((Bridges + Consts::BRIDGE_SPACES_TO_ADVANCE < Size) && ...), "Bridge targets in StaticBoard");
+
+            constexpr StaticBoard() : spaces{}, jumps{}, moves{} {
+                ((spaces[Bridges] = BRIDGE), ...);
+                ((jumps[Bridges] = Bridges + Consts::BRIDGE_SPACES_TO_ADVANCE), ...);
+                ((spaces[Gooses] = GOOSE), ...);
+                spaces[Size - 1] = FINISH;
+
+                for (size_type position = 0; position < Size; ++position) {
+                    for (size_type dice = MIN_DICE; dice <= MAX_DICE; ++dice) {
+                        Board::Move& move = moves[position * MOVES_PER_SPACE + dice - MIN_DICE];
+                        MoveRecorder recorder(move);
+                        move.target = resolveMove(position, dice, recorder);
+                    }
+                }
+            }
+
+            constexpr SpaceType get(const size_type position) const {
+                return static_cast<SpaceType>(spaces[position]);
+            }
+
+            constexpr size_type getLastIndex() const {
+                return Size - 1;
+            }
+
+            constexpr bool isNormalPosition(const size_type position) const {
+                return (position < Size) && (spaces[position] == NORMAL);
+            }
+
+            constexpr size_type getJump(const size_type position) const {
+                return jumps[position];
+            }
+
+            template<class Listener>
+            constexpr size_type resolveMove(size_type position, const size_type dice, Listener& listener) const {
+                return walkMove(*this, position, dice, listener);
+            }
+
+            constexpr const Board::Move& getMove(const size_type position, const size_type dice) const {
+                return moves[position * MOVES_PER_SPACE + dice - MIN_DICE];
+            }
+
+            // a runtime Board with a copy of the precompiled table, for the code working on any layout
+            std::shared_ptr<Board> toBoard() const {
+                return std::make_shared<Board>(
+                    std::vector<std::uint8_t>(spaces.begin(), spaces.end()),
+                    std::vector<std::uint32_t>(jumps.begin(), jumps.end()),
+                    std::vector<Board::Move>(moves.begin(), moves.end()));
+            }
+        private:
+            std::array<std::uint8_t, Size> spaces;
+            std::array<std::uint32_t, Size> jumps;
+            std::array<Board::Move, Size * MOVES_PER_SPACE> moves;
+    };
+
+    // the SpaceList of the spaces in a constant array
+    template<const auto& Spaces, class = std::make_index_sequence<std::size(Spaces)>>
+    struct SpaceListOf;
+
+    template<const auto& Spaces, std::size_t... Indexes>
+    struct SpaceListOf<Spaces, std::index_sequence<Indexes...>> {
+        typedef SpaceList<Spaces[Indexes]...> type;
+    };
+
+    // the standard layout of Consts
+    typedef StaticBoard<Consts::SPACE_COUNT, SpaceListOf<Consts::GOOSE_SPACES>::type,
+                        SpaceListOf<Consts::BRIDGE_SPACES>::type> ClassicBoard;
+
+    inline constexpr ClassicBoard CLASSIC_BOARD {};
+
+    static_assert(CLASSIC_BOARD.getMove(0, 6).target == 12 && CLASSIC_BOARD.getMove(0, 6).bridges == 1, "The Bridge");
+    static_assert(CLASSIC_BOARD.getMove(10, 4).target == 22 && CLASSIC_BOARD.getMove(10, 4).gooseHops == 2, "The Goose");
+    static_assert(CLASSIC_BOARD.getMove(60, 5).target == 61 && CLASSIC_BOARD.getMove(60, 5).bounces == 1, "Bounce");
+    static_assert(CLASSIC_BOARD.getMove(60, 3).wins, "Finish");
+  }
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "tournament.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+
+#include "rng.hpp"
+
+using namespace std;
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Tournament
+      */
+    Tournament::Table::Table(const Players& players, std::shared_ptr<const Board> board) :
+        game(players, std::move(board)) {
+    }
+
+    Tournament::Tournament(const Players& players, std::shared_ptr<const Board> board, const PlayerSlot tableSize,
+                           const std::uint64_t seed) :
+        players(players), board(std::move(board)), tableSize(tableSize), seed(seed) {
+        if (tableSize < 2) {
+            throw invalid_argument("tableSize in Tournament constructor");
+        }
+        entrants.resize(players.size());
+        std::iota(entrants.begin(), entrants.end(), 0);
+        mt::Xoshiro256 random(seed);
+        std::shuffle(entrants.begin(), entrants.end(), random);
+    }
+
+    bool Tournament::playRound(mt::WorkStealingPool& pool) {
+        if (isOver()) {
+            return false;
+        }
+        auto start = chrono::steady_clock::now();
+        while (tables.size() < pool.getThreadCount()) {
+            tables.push_back(std::make_unique<Table>(players, board));
+        }
+
+        // as many tables as needed, their sizes differing by one at most
+        const std::size_t count = entrants.size();
+        const std::size_t tableCount = (count + tableSize - 1) / tableSize;
+        const std::uint64_t roundSeed = mt::Xoshiro256::streamSeed(seed, rounds.size());
+        std::vector<PlayerId> winners(tableCount);
+        std::vector<std::uint32_t> turns(tableCount, 0);
+
+        pool.parallelFor(tableCount, [&](const std::size_t table, const unsigned int worker) {
+            const std::size_t begin = count * table / tableCount;
+            const std::size_t end = count * (table + 1) / tableCount;
+            winners[table] = play(*tables[worker], entrants.data() + begin, end - begin,
+                                  mt::Xoshiro256::streamSeed(roundSeed, table), turns[table]);
+        });
+
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        rounds.push_back({static_cast<std::uint32_t>(count), static_cast<std::uint32_t>(tableCount),
+                          std::accumulate(turns.begin(), turns.end(), std::uint64_t(0)), elapsed.count()});
+        entrants = std::move(winners);
+        return true;
+    }
+
+    PlayerId Tournament::run(mt::WorkStealingPool& pool) {
+        while (playRound(pool)) {
+        }
+        return entrants.empty() ? Players::NO_PLAYER : entrants.front();
+    }
+
+    PlayerId Tournament::play(Table& table, const PlayerId* seats, const PlayerSlot count, const std::uint64_t seed,
+                              std::uint32_t& turns) {
+        if (count == 1) {
+            return seats[0];
+        }
+        // slots follow the order of the player ids
+        table.ids.assign(seats, seats + count);
+        std::sort(table.ids.begin(), table.ids.end());
+        table.spaces.assign(count, 0);
+
+        Game& game = table.game;
+        game.restore(table.ids.data(), table.spaces.data(), count, GamePlayers::NO_SLOT);
+        game.seed(seed);
+        // the first mover is drawn for every table, or the lowest id would always move first
+        mt::Xoshiro256 order(mt::Xoshiro256::streamSeed(seed, 1));
+        for (PlayerSlot slot = order() % count; !game.hasWinner(); slot = (slot + 1) % count) {
+            game.move(slot);
+            ++turns;
+        }
+        return game.getPlayers().getPlayerId(game.getWinnerSlot());
+    }
+  } // namespace core
+} // namespace goose_game
@@ -0,0 +1,81 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core.hpp"
+#include "work_pool.hpp"
+
+namespace goose_game {
+  namespace core {
+
+    /**
+      * Summary of one round of a Tournament
+      */
+    struct TournamentRound {
+        std::uint32_t players;
+        std::uint32_t tables;
+        std::uint64_t turns;    // moves played at all the tables together
+        double seconds;
+    };
+
+    /**
+      * Knockout tournament among the players of a roster. Every round seats the
+      * players still in at tables of at most tableSize, plays all the tables on
+      * a work-stealing pool and sends the winner of each table on to the next
+      * round, in bracket order, until one player is left. A table left with one
+      * player is a bye.
+      * Every table draws its dice from its own stream, derived from the seed, the
+      * round and the table: the same seed gives the same brackets whatever the
+      * number of threads. The roster must not change while a round is played.
+      */
+    class Tournament {
+        public:
+            Tournament(const Players& players, std::shared_ptr<const Board> board, const PlayerSlot tableSize,
+                       const std::uint64_t seed);
+
+            // plays one round, false when there is a champion already
+            bool playRound(mt::WorkStealingPool& pool);
+
+            // plays every round left and returns the champion
+            PlayerId run(mt::WorkStealingPool& pool);
+
+            inline bool isOver() const {
+                return entrants.size() <= 1;
+            }
+
+            // the players still in, in bracket order: the champion once over
+            inline const std::vector<PlayerId>& getEntrants() const {
+                return entrants;
+            }
+
+            inline const std::vector<TournamentRound>& getRounds() const {
+                return rounds;
+            }
+        private:
+            // the game and scratch space of one pool worker, reused for all its tables
+            struct Table {
+                Table(const Players& players, std::shared_ptr<const Board> board);
+
+                Game game;
+                std::vector<PlayerId> ids;
+                std::vector<std::uint32_t> spaces;
+            };
+
+            PlayerId play(Table& table, const PlayerId* seats, const PlayerSlot count, const std::uint64_t seed,
+                          std::uint32_t& turns);
+
+            const Players& players;
+            std::shared_ptr<const Board> board;
+            PlayerSlot tableSize;
+            std::uint64_t seed;
+            std::vector<PlayerId> entrants;
+            std::vector<TournamentRound> rounds;
+            std::vector<std::unique_ptr<Table>> tables;
+    };
+  } // namespace core
+} // namespace goose_game
+
+#endif //TOURNAMENT_H
@@ -1,7 +1,14 @@
 #include "view.hpp"
 #include "core.hpp"
+#include "metrics.hpp"
 #include "mt.hpp"
-#include <sstream>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
 
 using namespace std;
 using namespace goose_game::core;
@@ -13,58 +20,85 @@ namespace goose_game {
     * View
     */
     View* View::println(const string &line) {
-      cout << line << endl;
+      // no flush, cout is tied to cin and flushes before the next read
+      cout << line << '\n';
       return this;
     }
 
 
-    MoveArgs::MoveArgs(int firstDice, int secondDice, const std::string& playerName) :
+    MoveArgs::MoveArgs(int firstDice, int secondDice, std::string_view playerName) :
       firstDice{firstDice}, secondDice{secondDice}, playerName{playerName} {
     }
 
-    MoveArgs MoveArgs::parseMoveArgs(const std::string& string) {
-      std::stringstream stream {string};
-      std::string cur;
+    MoveArgs::Result MoveArgs::parse(std::string_view args) {
+      GOOSE_TIME(COMMAND_PARSE);
       int countTokens {0}, firstDice {0}, secondDice{0};
-      std::string playerName="";
 
-      stream >> cur;
-      playerName = cur;
+      // the first word is the player name
+      std::size_t begin = 0;
+      while ( (begin < args.size()) && mt::is_space(args[begin]) ) {
+        ++begin;
+      }
+      std::size_t end = begin;
+      while ( (end < args.size()) && !mt::is_space(args[end]) ) {
+        ++end;
+      }
+      std::string_view playerName = args.substr(begin, end - begin);
+      if (playerName.empty()) {
+        return mt::unexpected(Failure{Error::NAME_REQUIRED, args});
+      }
       ++countTokens;
 
-      while (getline(stream, cur, ',')) {
-        int i;
-        mt::trim(cur);
-        try {
-            i = std::stoi(cur);
-        } catch (std::invalid_argument& e) {
-            throw invalid_argument(mt::string_format(Messages::INVALID_DICE_ARG, cur.c_str()));
-        }
+      // the rest are the dice, comma separated
+      std::string_view rest = mt::trim_view(args.substr(end));
+      while (!rest.empty()) {
+        std::size_t comma = rest.find(',');
+        std::string_view token = mt::trim_view(rest.substr(0, comma));
+        rest = (comma == std::string_view::npos) ? std::string_view() : rest.substr(comma + 1);
 
-        if ( (i < 1) || (i > 6) ) {
-            throw invalid_argument(mt::string_format(Messages::INVALID_DICE_ARG, cur.c_str()));
-        }
+        int i = parseDice(token);
         ++countTokens;
-        switch (countTokens) {
+        switch ( (i != 0) ? countTokens : 0 ) {
             case 2 : firstDice = i;
                 break;
             case 3 : secondDice = i;
                 break;
             default :
-              throw invalid_argument(mt::string_format(Messages::INVALID_DICE_ARG, cur.c_str()));
+              return mt::unexpected(Failure{Error::INVALID_DICE, token});
         }
       }
 
-      if ( countTokens == 0) {
-          throw invalid_argument(Messages::MOVE_PLAYER_NAME_IS_REQUIRED);
-      }
       if ( (countTokens != 1)  && (countTokens != 3) ) {
-          throw invalid_argument(Messages::MOVE_PLAYER_INVALID_ARGS);
+        return mt::unexpected(Failure{Error::INVALID_ARGS, args});
       }
 
       return MoveArgs(firstDice, secondDice, playerName);
     }
 
+    int MoveArgs::parseDice(std::string_view token) {
+      int value = 0;
+      const char* last = token.data() + token.size();
+      auto [end, ec] = std::from_chars(token.data(), last, value);
+      if ( (ec != std::errc()) || (end != last) || (value < 1) || (value > 6) ) {
+        return 0;
+      }
+      return value;
+    }
+
+    void MoveArgs::describe(const Failure& failure, mt::Sink& out) {
+      switch (failure.error) {
+        case Error::NAME_REQUIRED :
+          out.write(Messages::MOVE_PLAYER_NAME_IS_REQUIRED);
+          break;
+        case Error::INVALID_DICE :
+          mt::format_to(out, Messages::INVALID_DICE_ARG, static_cast<int>(failure.token.size()), failure.token.data());
+          break;
+        case Error::INVALID_ARGS :
+          out.write(Messages::MOVE_PLAYER_INVALID_ARGS);
+          break;
+      }
+    }
+
     /**
     * GameView
     */
@@ -73,34 +107,145 @@ namespace goose_game {
     };
 
     View* GameView::show() {
+      mt::OStreamSink out(cout);
       while (!game->hasWinner()) {
         cout << core::Messages::GAME_MENU;
         std::string input;
-        getline(cin, input);
-        if (input.find(Consts::MOVE_PLAYER_COMMAND) == 0) {
-          std::string args = input.substr(Consts::MOVE_PLAYER_COMMAND.length());
-
-          try {
-            MoveArgs moveArgs = MoveArgs::parseMoveArgs(args);
-            if (moveArgs.isComplete()) {
-                cout << game->movePlayer(moveArgs.getPlayerName(),moveArgs.getFirstDice(),moveArgs.getSecondDice()) << "\n";
-            } else {
-                cout << game->moveThrowingDice(moveArgs.getPlayerName()) << "\n";
-            }
-          } catch (exception& e) {
-            cout << "error\n" <<  e.what();
-          }
-        } else if (input == Consts::EXIT_COMMAND) {
-          cout << Messages::GAME_QUITTED;
+        if (!getline(cin, input) || !execute(*game, input, out)) {
           break;
-        } else {
-          cout << Messages::UNKNOWN_COMMAND;
         }
       }
 
       return this;
     }
 
+    bool GameView::execute(core::Game& game, std::string_view input, mt::Sink& out) {
+      if (mt::starts_with(input, Consts::MOVE_PLAYER_COMMAND)) {
+        std::string_view args = input.substr(Consts::MOVE_PLAYER_COMMAND.length());
+
+        MoveArgs::Result moveArgs = MoveArgs::parse(args);
+        if (!moveArgs) {
+          out.write("error\n", 6);
+          MoveArgs::describe(moveArgs.error(), out);
+        } else if (moveArgs->isComplete()) {
+          game.movePlayer(moveArgs->getPlayerName(), moveArgs->getFirstDice(), moveArgs->getSecondDice(), out);
+          out.write("\n", 1);
+        } else {
+          game.moveThrowingDice(moveArgs->getPlayerName(), out);
+          out.write("\n", 1);
+        }
+      } else if (input == Consts::EXIT_COMMAND) {
+        out.write(Messages::GAME_QUITTED);
+        return false;
+      } else {
+        out.write(Messages::UNKNOWN_COMMAND);
+      }
+      return true;
+    }
+
+    /**
+     * JsonRenderer
+     */
+    const JsonRenderer JsonRenderer::INSTANCE;
+
+    namespace {
+      const std::string MOVE_FIELDS = ",\"dice\":[%u,%u],\"from\":%zu,\"to\":%u,\"gooseHops\":%u,\"bridges\":%u,"
+          "\"bounces\":%u,\"deaths\":%u,\"wins\":%s,\"overtime\":%s";
+
+      void writeJsonString(std::string_view text, mt::Sink& out) {
+        out.write("\"", 1);
+        std::size_t begin = 0;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+          unsigned char c = text[i];
+          if ( (c == '"') || (c == '\\') || (c < 0x20) ) {
+            out.write(text.data() + begin, i - begin);
+            mt::format_to(out, "\\u%04x", c);
+            begin = i + 1;
+          }
+        }
+        out.write(text.data() + begin, text.size() - begin);
+        out.write("\"", 1);
+      }
+    }
+
+    void JsonRenderer::render(const core::Game& game, const core::MoveResult& result, mt::Sink& out) const {
+      const core::GamePlayers& players = game.getPlayers();
+      out.write("{\"player\":", 10);
+      writeJsonString(players.getPlayer(result.player).getName(), out);
+      const core::Board::Move& move = result.move;
+      mt::format_to(out, MOVE_FIELDS, result.firstDice, result.secondDice, result.from, move.target,
+              move.gooseHops, move.bridges, move.bounces, move.deaths, move.wins ? "true" : "false", result.overtime ? "true" : "false");
+      if (result.pranked != core::GamePlayers::NO_SLOT) {
+        out.write(",\"pranked\":", 11);
+        writeJsonString(players.getPlayer(result.pranked).getName(), out);
+      }
+      out.write("}", 1);
+    }
+
+    /**
+     * Session
+     */
+
+    Session::Session(core::Journal* journal) : app_model(journal) {
+    }
+
+    Session::Session(std::shared_ptr<core::Players> players, core::Journal* journal) :
+        app_model(std::move(players), journal) {
+    }
+
+    bool Session::execute(std::string_view input, mt::Sink& out) {
+      if (closed) {
+        return false;
+      }
+      GOOSE_TIME(COMMAND);
+      GOOSE_COUNT(COMMANDS, 1);
+
+      if (isPlaying()) {
+        if (!GameView::execute(*game, input, out) || game->hasWinner()) {
+          game.reset();
+        }
+      } else if (mt::starts_with(input, Consts::ADD_PLAYER_COMMAND)) {
+        string player_name(mt::trim_view(input.substr(Consts::ADD_PLAYER_COMMAND.size())));
+        out.write(app_model.addPlayer(player_name));
+        out.write("\n", 1);
+      } else if (mt::starts_with(input, Consts::LIST_PLAYERS_COMMAND)) {
+        listPlayers(input.substr(Consts::LIST_PLAYERS_COMMAND.size()), out);
+      } else if (input == Consts::PLAY_COMMAND) {
+        game = app_model.acquireGame();
+        game->setRenderer(*renderer);
+      } else if (input == Consts::EXIT_COMMAND) {
+        out.write(Messages::BYE);
+        out.write("\n", 1);
+        closed = true;
+#ifdef GOOSE_METRICS
+      } else if (input == Consts::METRICS_COMMAND) {
+        metrics::Totals::collect().writePrometheus(out);
+#endif
+      } else {
+        out.write(Messages::UNKNOWN_COMMAND);
+        out.write("\n", 1);
+      }
+      return !closed;
+    }
+
+    void Session::listPlayers(std::string_view args, mt::Sink& out) const {
+      args = mt::trim_view(args);
+      std::uint64_t page = 1;
+      if (!args.empty()) {
+        auto [end, ec] = std::from_chars(args.data(), args.data() + args.size(), page);
+        if ( (ec != std::errc()) || (end != args.data() + args.size()) || (page == 0) ) {
+          mt::format_to(out, Messages::INVALID_PAGE, static_cast<int>(args.size()), args.data());
+          out.write("\n", 1);
+          return;
+        }
+      }
+      out.write("players: ", 9);
+      if (page - 1 < Players::NO_PLAYER / Consts::PLAYERS_PAGE_SIZE) {
+        app_model.writePlayers(out, (page - 1) * Consts::PLAYERS_PAGE_SIZE, Consts::PLAYERS_PAGE_SIZE);
+      }
+      out.write("\n\n", 2);
+    }
+
     /**
      * AppView
      */
@@ -108,31 +253,78 @@ namespace goose_game {
     AppView::AppView() {
     };
 
-    AppView* AppView::startNewGame() {
-      std::unique_ptr<Game> game(app_model.createNewGame());  
-      GameView(game.get()).show();
+    View* AppView::show() {
+      mt::OStreamSink out(cout);
+      while (!session.isClosed()) {
+        if (session.isPlaying()) {
+          cout << Messages::GAME_MENU;
+        } else {
+          println(Messages::APP_MENU);
+        }
+        string input;
+        if (!getline(cin, input)) {
+          break;
+        }
+        session.execute(input, out);
+      }
       return this;
     }
+ 
+    /**
+     * BatchView
+     */
 
-    View* AppView::show() {
-      while (true) {
-        println(Messages::APP_MENU);
-        string input;
-        getline(cin, input);
-
-        if (input.find(Consts::ADD_PLAYER_COMMAND) == 0) {
-          string player_name = mt::trim_copy(input.substr(Consts::ADD_PLAYER_COMMAND.size()));
-          println(app_model.addPlayer(player_name));
-        } else if (input == Consts::PLAY_COMMAND) {
-          startNewGame();
-        } else if (input == Consts::EXIT_COMMAND) {
-          println(Messages::BYE);
+    BatchView::BatchView(const std::string& path, const core::MoveRenderer& renderer) : path(path) {
+      session.setRenderer(renderer);
+    };
+
+    View* BatchView::show() {
+      mt::FdSink out(STDOUT_FILENO);
+      if (!path.empty()) {
+        mt::MappedFile script(path);
+        run(session, std::string_view(script.data(), script.size()), true, out);
+        return this;
+      }
+
+      // the standard input in large blocks, carrying the partial last line over
+      std::vector<char> block(1 << 20);
+      std::size_t pending = 0;
+      while (!session.isClosed()) {
+        if (pending == block.size()) {
+          block.resize(block.size() * 2);
+        }
+        ssize_t count = ::read(STDIN_FILENO, block.data() + pending, block.size() - pending);
+        if ( (count < 0) && (errno == EINTR) ) {
+          continue;
+        }
+        bool last = (count <= 0);
+        std::size_t size = pending + std::max<ssize_t>(count, 0);
+        std::size_t consumed = run(session, std::string_view(block.data(), size), last, out);
+        if (last) {
           break;
-        } else {
-          println(Messages::UNKNOWN_COMMAND);
         }
+        pending = size - consumed;
+        std::memmove(block.data(), block.data() + consumed, pending);
       }
       return this;
     }
+
+    std::size_t BatchView::run(Session& session, std::string_view text, bool last, mt::Sink& out) {
+      std::size_t begin = 0;
+      while ( (begin < text.size()) && !session.isClosed() ) {
+        const void* newline = std::memchr(text.data() + begin, '\n', text.size() - begin);
+        if (newline == nullptr) {
+          if (last) {
+            session.execute(text.substr(begin), out);
+            begin = text.size();
+          }
+          break;
+        }
+        std::size_t end = static_cast<const char*>(newline) - text.data();
+        session.execute(text.substr(begin, end - begin), out);
+        begin = end + 1;
+      }
+      return begin;
+    }
   }
 }
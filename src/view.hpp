@@ -2,7 +2,9 @@
 #define VIEW_H
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <memory>
 
 #include "core.hpp"
 
@@ -19,29 +21,51 @@ namespace goose_game {
 
     class MoveArgs {
        public:
-         MoveArgs(int firstDice, int secondDice, const std::string& playerName);
+         enum class Error {
+           NAME_REQUIRED,
+           INVALID_DICE,
+           INVALID_ARGS
+         };
 
-         inline bool isComplete() {
+         // why the arguments were rejected, and the offending token
+         struct Failure {
+           Error error;
+           std::string_view token;
+         };
+
+         typedef mt::Expected<MoveArgs, Failure> Result;
+
+         MoveArgs(int firstDice, int secondDice, std::string_view playerName);
+
+         inline bool isComplete() const {
             return (secondDice != 0);
          }
 
-         inline int getFirstDice() {
+         inline int getFirstDice() const {
             return firstDice;
          }
 
-         inline int getSecondDice() {
+         inline int getSecondDice() const {
             return secondDice;
          }
 
-         inline const std::string& getPlayerName() {
+         // a view of the parsed text
+         inline std::string_view getPlayerName() const {
             return playerName;
          }
 
-        static MoveArgs parseMoveArgs(const std::string& string);
+        // neither throws nor allocates, bad input costs as much as good input
+        static Result parse(std::string_view args);
+
+        // writes the message of the failure
+        static void describe(const Failure& failure, mt::Sink& out);
       private:
+        // the dice value, or 0 when the token is not a number in 1..6
+        static int parseDice(std::string_view token);
+
         int firstDice;
         int secondDice;
-        std::string playerName;
+        std::string_view playerName;
     };
 
 
@@ -51,18 +75,86 @@ namespace goose_game {
       public:
         GameView(core::Game* game);
         virtual View* show();
+
+        // runs one game command, returns false when the game is quitted
+        static bool execute(core::Game& game, std::string_view input, mt::Sink& out);
     };
 
 
-    class AppView : public View {
+    /**
+     * Moves as JSON objects, one per reply line
+     */
+    class JsonRenderer : public core::MoveRenderer {
+      public:
+        static const JsonRenderer INSTANCE;
+
+        virtual void render(const core::Game& game, const core::MoveResult& result, mt::Sink& out) const;
+    };
+
+
+    /**
+     * Command interpreter of one client: the app and game commands
+     * as a state machine, replying through a sink
+     */
+    class Session {
+      public:
+        // the games of the session are logged to the journal, when given
+        explicit Session(core::Journal* journal = nullptr);
+        // registers the players in a registry shared with other sessions, keeping its own roster
+        explicit Session(std::shared_ptr<core::Players> players, core::Journal* journal = nullptr);
+
+        // runs one command line, returns false once the client has exited
+        bool execute(std::string_view input, mt::Sink& out);
+
+        inline bool isPlaying() const {
+          return game != nullptr;
+        }
+
+        inline bool isClosed() const {
+          return closed;
+        }
+
+        // tells the moves of the games played from now on
+        inline void setRenderer(const core::MoveRenderer& renderer) {
+          this->renderer = &renderer;
+        }
       private:
+        // one page of the players, the first one without a page number
+        void listPlayers(std::string_view args, mt::Sink& out) const;
+
         core::App app_model;
+        core::GamePool::handle_type game;
+        const core::MoveRenderer* renderer = &core::TextRenderer::INSTANCE;
+        bool closed = false;
+    };
+
 
-        AppView* startNewGame();
+    class AppView : public View {
+      private:
+        Session session;
       public:
         AppView();
         virtual View* show();
     };
+
+
+    /**
+     * Non-interactive front-end for scripted and piped input: runs every line
+     * through one Session, without menus, replying through one buffered writer
+     */
+    class BatchView : public View {
+      private:
+        Session session;
+        std::string path;
+      public:
+        // reads the script from the file, or from the standard input when the path is empty
+        explicit BatchView(const std::string& path = "", const core::MoveRenderer& renderer = core::TextRenderer::INSTANCE);
+        virtual View* show();
+
+        // runs the complete lines of the text, returns the length consumed;
+        // with last set, a trailing line without newline is run as well
+        static std::size_t run(Session& session, std::string_view text, bool last, mt::Sink& out);
+    };
   }
 }
 
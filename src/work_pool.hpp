@@ -0,0 +1,71 @@
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mt.hpp"
+
+namespace mt {
+
+  /**
+    * Fixed set of threads running parallel loops with work stealing.
+    * Every worker starts with an even share of the indexes and takes them one
+    * at a time from the front of its range; a worker left without work steals
+    * the back half of the next busy range, so long tasks do not leave the other
+    * workers idle. The calling thread works as worker 0.
+    */
+  class WorkStealingPool : private NonAssignable {
+  public:
+    // hardware concurrency when threadCount is 0
+    explicit WorkStealingPool(unsigned int threadCount = 0);
+    ~WorkStealingPool();
+
+    inline unsigned int getThreadCount() const {
+        return ranges.size();
+    }
+
+    // index ranges taken from other workers so far
+    inline std::uint64_t getSteals() const {
+        return steals.load(std::memory_order_relaxed);
+    }
+
+    // runs task(index, worker) for every index in [0, count) and returns when all are done;
+    // the worker number, below getThreadCount(), lets tasks reuse per-worker state
+    void parallelFor(std::size_t count, const std::function<void(std::size_t, unsigned int)>& task);
+  private:
+    struct alignas(64) Range {
+        std::mutex lock;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    bool take(const unsigned int worker, std::size_t& index);
+    bool steal(const unsigned int worker);
+    void work(const unsigned int worker);
+    void loop(const unsigned int worker);
+
+    std::vector<std::unique_ptr<Range>> ranges;
+    std::vector<std::thread> threads;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(std::size_t, unsigned int)>* task = nullptr;
+    std::uint64_t generation = 0;
+    unsigned int busy = 0;
+    bool stopping = false;
+
+    std::atomic<std::size_t> remaining {0};
+    std::atomic<std::uint64_t> steals {0};
+  };
+}
+
+#endif //WORK_POOL_H
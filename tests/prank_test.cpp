@@ -0,0 +1,148 @@
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core.hpp"
+#include "sim.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+namespace {
+  unsigned int failures = 0;
+
+  void check(const bool condition, const std::string& what) {
+    if (!condition) {
+      cerr << "FAILED: " << what << endl;
+      ++failures;
+    }
+  }
+
+  // 24 spaces, a goose on 5, a bridge from 10 to 15 and death on 7 and 18
+  std::shared_ptr<const Board> deadlyBoard() {
+    std::vector<std::uint8_t> spaces(24, NORMAL);
+    std::vector<std::uint32_t> jumps(24, 0);
+    spaces[5] = GOOSE;
+    spaces[10] = BRIDGE;
+    jumps[10] = 15;
+    spaces[7] = spaces[18] = DEATH;
+    spaces[23] = FINISH;
+    return std::make_shared<const Board>(std::move(spaces), std::move(jumps));
+  }
+
+  void addPlayers(Players& players, const unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i) {
+      players.addPlayer(Player("player" + to_string(i)));
+    }
+  }
+
+  // a player sent back to Start pranks nobody, while any other space still does
+  void gameRule(const std::shared_ptr<const Board>& board) {
+    Players players;
+    addPlayers(players, 2);
+    Game game(players, board);
+    const PlayerId ids[] = {0, 1};
+
+    const std::uint32_t dying[] = {4, 0};
+    game.restore(ids, dying, 2, GamePlayers::NO_SLOT);
+    MoveResult result = game.move(0, 1, 2);
+    check(result.getTarget() == 0, "death sends the player back to Start");
+    check(result.pranked == GamePlayers::NO_SLOT, "a player sent back to Start pranks nobody");
+    check(game.getPlayers().getPosition(1) == 0, "the player waiting at Start stays there");
+
+    const std::uint32_t pranking[] = {1, 4};
+    game.restore(ids, pranking, 2, GamePlayers::NO_SLOT);
+    result = game.move(0, 1, 2);
+    check(result.pranked == 1, "a player landing on another one pranks it");
+    check(game.getPlayers().getPosition(1) == 1, "the pranked player goes where the other one came from");
+  }
+
+  struct SilentRenderer : MoveRenderer {
+    void render(const Game&, const MoveResult&, mt::Sink&) const override {
+    }
+  };
+
+  // a moved game keeps the dice it was seeded with and its renderer
+  void movedGame(const std::shared_ptr<const Board>& board) {
+    static const SilentRenderer silent;
+    Players players;
+    addPlayers(players, 2);
+    Game game(players, board), same(players, board);
+    game.seed(7).setRenderer(silent);
+    same.seed(7);
+    game.move(0);
+    same.move(0);
+
+    Game moved(std::move(game));
+    bool sameDice = true;
+    for (PlayerSlot slot = 1; !same.hasWinner(); slot = (slot + 1) % 2) {
+      const MoveResult expected = same.move(slot);
+      const MoveResult result = moved.move(slot);
+      sameDice &= (result.firstDice == expected.firstDice) && (result.secondDice == expected.secondDice);
+    }
+    check(sameDice, "a moved game rolls the dice it was seeded with");
+    check(&moved.getRenderer() == &silent, "a moved game keeps its renderer");
+  }
+
+  // the Simulator plays the same games as Game with the same dice, and so does every lane of a BatchSimulator
+  void simulators(const std::shared_ptr<const Board>& board, const unsigned int playerCount, const unsigned int games) {
+    Players players;
+    addPlayers(players, playerCount);
+    Game game(players, board);
+    Simulator simulator(board, playerCount);
+    BatchSimulator batch(board, playerCount, games);
+    std::vector<GameResult> batchResults(batch.getLaneCount());
+    bool startPranked = false, sameAsGame = true, sameAsBatch = true;
+
+    for (unsigned int lane = 0; lane < games; ++lane) {
+      batch.assign(lane, lane, 1);
+    }
+    while (batch.getActiveCount() > 0) {
+      batch.step([&](const unsigned int lane, const GameResult& result) {
+        batchResults[lane] = result;
+      });
+    }
+
+    for (unsigned int i = 0; i < games; ++i) {
+      game.reset().seed(i);
+      GameResult expected {0, 0, 0, 0};
+      for (PlayerSlot slot = 0; !game.hasWinner(); slot = (slot + 1) % playerCount) {
+        const MoveResult result = game.move(slot);
+        startPranked |= (result.getTarget() == 0) && (result.pranked != GamePlayers::NO_SLOT);
+        ++expected.turns;
+        expected.pranks += (result.pranked != GamePlayers::NO_SLOT);
+        expected.bounces += result.move.bounces;
+      }
+      expected.winner = game.getWinnerSlot();
+
+      simulator.seed(i);
+      const GameResult result = simulator.play();
+      sameAsGame &= (result.winner == expected.winner) && (result.turns == expected.turns)
+          && (result.pranks == expected.pranks) && (result.bounces == expected.bounces);
+      const GameResult& lane = batchResults[i];
+      sameAsBatch &= (lane.winner == result.winner) && (lane.turns == result.turns)
+          && (lane.pranks == result.pranks) && (lane.bounces == result.bounces);
+    }
+    check(!startPranked, "no game pranks a player at Start");
+    check(sameAsGame, "Simulator plays the games of Game");
+    check(sameAsBatch, std::string("every lane of BatchSimulator plays the games of Simulator")
+          + (BatchSimulator::isVectorized() ? " (AVX2)" : ""));
+  }
+}
+
+/*
+ * usage: prank_test [games] [players]
+ */
+int main(int argc, char* argv[]) {
+  const unsigned int games = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 2000;
+  const unsigned int playerCount = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 4;
+
+  const std::shared_ptr<const Board> board = deadlyBoard();
+  gameRule(board);
+  movedGame(board);
+  simulators(board, playerCount, games);
+  cout << "prank_test: " << (failures == 0 ? "OK" : "FAILED") << endl;
+  return (failures == 0) ? 0 : 1;
+}
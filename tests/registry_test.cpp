@@ -0,0 +1,124 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core.hpp"
+
+using namespace std;
+using namespace goose_game::core;
+
+namespace {
+  unsigned int failures = 0;
+
+  void check(const bool condition, const std::string& what) {
+    if (!condition) {
+      cerr << "FAILED: " << what << endl;
+      ++failures;
+    }
+  }
+
+  std::string names(const App& app) {
+    std::string text;
+    mt::StringSink sink(text);
+    app.writePlayers(sink, 0, Players::NO_PLAYER);
+    return text;
+  }
+
+  /**
+    * Every thread adds all the names, each from its own starting point, while a reader
+    * lists the roster: each name must be taken exactly once, the ids must have no holes
+    * and every roster read must be the start of the next one.
+    */
+  void concurrentRegistration(const unsigned int playerCount, const unsigned int threadCount) {
+    auto players = std::make_shared<Players>();
+    std::atomic<unsigned int> added {0};
+    std::atomic<bool> done {false};
+    bool ordered = true;
+    bool listed = true;
+
+    std::thread reader([&]() {
+      std::string previous;
+      while (!done.load()) {
+        std::string roster = players->getAllPlayersAsString();
+        ordered &= (roster.compare(0, previous.size(), previous) == 0);
+        // the players listed are all fully added
+        const Players::Range all = players->getAll();
+        PlayerId named = 0;
+        for (const Player& player : all) {
+          named += !player.getName().empty();
+        }
+        listed &= (named == all.size());
+        previous.swap(roster);
+      }
+      ordered &= (players->getAllPlayersAsString().compare(0, previous.size(), previous) == 0);
+    });
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&, t]() {
+        unsigned int mine = 0;
+        for (unsigned int i = 0; i < playerCount; ++i) {
+          const std::string name = "player" + to_string((i + std::uint64_t(t) * playerCount / threadCount) % playerCount);
+          mine += (players->addPlayer(Player(name)) != Players::NO_PLAYER);
+        }
+        added += mine;
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    done = true;
+    reader.join();
+
+    check(added.load() == playerCount, "every name is added exactly once");
+    check(players->size() == playerCount, "the registry holds every name");
+    bool found = true;
+    for (PlayerId id = 0; found && (id < players->size()); ++id) {
+      found = (players->findId(players->get(id).getName()) == id);
+    }
+    for (unsigned int i = 0; found && (i < playerCount); ++i) {
+      found = (players->findId("player" + to_string(i)) != Players::NO_PLAYER);
+    }
+    check(found, "every id is found again by its name");
+    check(ordered, "every roster read is the start of the next one");
+    check(listed, "the players listed are all added");
+  }
+
+  // apps sharing a registry keep their own rosters and games
+  void sharedRegistry() {
+    auto players = std::make_shared<Players>();
+    App first(players), second(players);
+    first.addPlayer("Pippo");
+    first.addPlayer("Pluto");
+    check(second.addPlayer("Pippo") == mt::string_format(Messages::PLAYER_ADDED, "Pippo"),
+          "a name taken by another app joins the roster");
+    check(second.addPlayer("Pippo") == mt::string_format(Messages::ALREADY_EXISTING_PLAYER, "Pippo"),
+          "a name of the roster is refused");
+    second.addPlayer("Paperino");
+    check(players->size() == 3, "the registry holds each name once");
+    check(names(first) == "Pippo, Pluto", "the first roster lists its own players");
+    check(names(second) == "Pippo, Paperino", "the second roster lists its own players");
+
+    auto game = second.acquireGame();
+    check(game->getPlayers().size() == 2, "a game seats the players of its app only");
+    check(game->getPlayers().findSlot("Pluto") == GamePlayers::NO_SLOT, "a game seats no player of another app");
+    check(game->getPlayers().getPlayer(1).getName() == "Paperino", "the players are seated by id");
+  }
+}
+
+/*
+ * usage: registry_test [players] [threads]
+ */
+int main(int argc, char* argv[]) {
+  const unsigned int playerCount = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 20000;
+  const unsigned int threadCount = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 8;
+
+  concurrentRegistration(playerCount, threadCount);
+  sharedRegistry();
+  cout << "registry_test: " << (failures == 0 ? "OK" : "FAILED") << endl;
+  return (failures == 0) ? 0 : 1;
+}